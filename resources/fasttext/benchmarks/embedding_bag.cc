@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Measures the embedding bag of Model::computeHidden, i.e. the gather of the
+// input rows of every word and ngram of a channel, for several software
+// prefetch distances. Channels are built from consecutive lines of a text
+// file, one post per line.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../src/fasttext.h"
+
+using namespace fasttext;
+
+namespace {
+
+// Hardware cache miss counter of the calling thread, if the kernel lets us.
+class MissCounter {
+ public:
+  MissCounter() : fd_(-1) {
+#ifdef __linux__
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+  ~MissCounter() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+
+  bool available() const {
+    return fd_ >= 0;
+  }
+
+  void start() {
+#ifdef __linux__
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  int64_t stop() {
+    int64_t count = 0;
+#ifdef __linux__
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+ private:
+  int fd_;
+};
+
+void printUsage() {
+  std::cerr
+      << "usage: fasttext-bench-bag <model> <text> [<posts>] [<repeats>]\n\n"
+      << "  <model>    dense model filename\n"
+      << "  <text>     text filename, one post per line\n"
+      << "  <posts>    (optional; 50 by default) posts per channel\n"
+      << "  <repeats>  (optional; 5 by default) passes over all channels\n"
+      << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  const int32_t posts = argc > 3 ? std::atoi(argv[3]) : 50;
+  const int32_t repeats = argc > 4 ? std::atoi(argv[4]) : 5;
+
+  FastText fasttext;
+  fasttext.loadModel(argv[1]);
+  std::shared_ptr<const Dictionary> dict = fasttext.getDictionary();
+  std::shared_ptr<const DenseMatrix> input = fasttext.getInputMatrix();
+
+  std::ifstream ifs(argv[2]);
+  if (!ifs.is_open()) {
+    std::cerr << argv[2] << " cannot be opened!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<std::vector<int32_t>> channels;
+  std::vector<int32_t> words, labels;
+  std::string line;
+  int32_t n = 0;
+  int64_t tokens = 0;
+  while (std::getline(ifs, line)) {
+    if (n++ % posts == 0) {
+      channels.emplace_back();
+    }
+    std::istringstream iss(line);
+    dict->getLine(iss, words, labels);
+    channels.back().insert(channels.back().end(), words.begin(), words.end());
+    tokens += words.size();
+  }
+  std::cerr << channels.size() << " channels of " << posts << " posts, "
+            << tokens << " rows, dim " << input->cols() << std::endl;
+
+  MissCounter counter;
+  if (!counter.available()) {
+    std::cerr << "cache miss counter unavailable (perf_event_open)"
+              << std::endl;
+  }
+  std::cout << "distance  ns/row  misses/row" << std::endl;
+  Vector hidden(input->cols());
+  // first touch of the rows, page faults are not part of the measure
+  for (const auto& ids : channels) {
+    input->addRowsToVector(hidden, ids.data(), ids.size());
+  }
+  const int32_t distances[] = {0, 1, 2, 4, 8, 16};
+  for (int32_t distance : distances) {
+    fasttext.setPrefetchDistance(distance);
+    volatile real sink = 0.0; // keeps the sums alive
+    // the counter is switched once per distance, its syscalls are not timed
+    counter.start();
+    const auto start = std::chrono::steady_clock::now();
+    for (int32_t r = 0; r < repeats; r++) {
+      for (const auto& ids : channels) {
+        hidden.zero();
+        input->addRowsToVector(hidden, ids.data(), ids.size());
+        sink = sink + hidden[0];
+      }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    const int64_t misses = counter.stop();
+    const double rows = double(tokens) * repeats;
+    std::cout << std::setw(8) << distance << std::fixed << std::setprecision(2)
+              << std::setw(8) << ns / rows << std::setw(12);
+    if (counter.available()) {
+      std::cout << misses / rows;
+    } else {
+      std::cout << "n/a";
+    }
+    std::cout << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fasttext-bench-bag.dir/benchmarks/embedding_bag.cc.o"
+  "CMakeFiles/fasttext-bench-bag.dir/benchmarks/embedding_bag.cc.o.d"
+  "fasttext-bench-bag"
+  "fasttext-bench-bag.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fasttext-bench-bag.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
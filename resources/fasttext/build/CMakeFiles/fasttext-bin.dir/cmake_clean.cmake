@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fasttext-bin.dir/src/main.cc.o"
+  "CMakeFiles/fasttext-bin.dir/src/main.cc.o.d"
+  "fasttext"
+  "fasttext.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fasttext-bin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
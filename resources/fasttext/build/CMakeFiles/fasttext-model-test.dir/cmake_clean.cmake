@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fasttext-model-test.dir/tests/model_test.cc.o"
+  "CMakeFiles/fasttext-model-test.dir/tests/model_test.cc.o.d"
+  "fasttext-model-test"
+  "fasttext-model-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fasttext-model-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
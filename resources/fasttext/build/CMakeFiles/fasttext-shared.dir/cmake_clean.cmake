@@ -0,0 +1,42 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fasttext-shared.dir/src/args.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/args.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/autotune.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/autotune.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/densematrix.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/densematrix.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/dictionary.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/dictionary.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/fasttext.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/fasttext.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/halfmatrix.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/halfmatrix.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/int8matrix.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/int8matrix.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/loss.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/loss.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/main.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/main.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/matrix.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/matrix.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/meter.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/meter.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/model.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/model.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/productquantizer.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/productquantizer.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/quantmatrix.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/quantmatrix.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/utils.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/utils.cc.o.d"
+  "CMakeFiles/fasttext-shared.dir/src/vector.cc.o"
+  "CMakeFiles/fasttext-shared.dir/src/vector.cc.o.d"
+  "libfasttext.pdb"
+  "libfasttext.so"
+  "libfasttext.so.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fasttext-shared.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
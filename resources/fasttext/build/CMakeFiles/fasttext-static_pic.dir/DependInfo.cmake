@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/resources/fasttext/src/args.cc" "CMakeFiles/fasttext-static_pic.dir/src/args.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/args.cc.o.d"
+  "/root/repo/resources/fasttext/src/autotune.cc" "CMakeFiles/fasttext-static_pic.dir/src/autotune.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/autotune.cc.o.d"
+  "/root/repo/resources/fasttext/src/densematrix.cc" "CMakeFiles/fasttext-static_pic.dir/src/densematrix.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/densematrix.cc.o.d"
+  "/root/repo/resources/fasttext/src/dictionary.cc" "CMakeFiles/fasttext-static_pic.dir/src/dictionary.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/dictionary.cc.o.d"
+  "/root/repo/resources/fasttext/src/fasttext.cc" "CMakeFiles/fasttext-static_pic.dir/src/fasttext.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/fasttext.cc.o.d"
+  "/root/repo/resources/fasttext/src/halfmatrix.cc" "CMakeFiles/fasttext-static_pic.dir/src/halfmatrix.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/halfmatrix.cc.o.d"
+  "/root/repo/resources/fasttext/src/int8matrix.cc" "CMakeFiles/fasttext-static_pic.dir/src/int8matrix.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/int8matrix.cc.o.d"
+  "/root/repo/resources/fasttext/src/loss.cc" "CMakeFiles/fasttext-static_pic.dir/src/loss.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/loss.cc.o.d"
+  "/root/repo/resources/fasttext/src/main.cc" "CMakeFiles/fasttext-static_pic.dir/src/main.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/main.cc.o.d"
+  "/root/repo/resources/fasttext/src/matrix.cc" "CMakeFiles/fasttext-static_pic.dir/src/matrix.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/matrix.cc.o.d"
+  "/root/repo/resources/fasttext/src/meter.cc" "CMakeFiles/fasttext-static_pic.dir/src/meter.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/meter.cc.o.d"
+  "/root/repo/resources/fasttext/src/model.cc" "CMakeFiles/fasttext-static_pic.dir/src/model.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/model.cc.o.d"
+  "/root/repo/resources/fasttext/src/productquantizer.cc" "CMakeFiles/fasttext-static_pic.dir/src/productquantizer.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/productquantizer.cc.o.d"
+  "/root/repo/resources/fasttext/src/quantmatrix.cc" "CMakeFiles/fasttext-static_pic.dir/src/quantmatrix.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/quantmatrix.cc.o.d"
+  "/root/repo/resources/fasttext/src/utils.cc" "CMakeFiles/fasttext-static_pic.dir/src/utils.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/utils.cc.o.d"
+  "/root/repo/resources/fasttext/src/vector.cc" "CMakeFiles/fasttext-static_pic.dir/src/vector.cc.o" "gcc" "CMakeFiles/fasttext-static_pic.dir/src/vector.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
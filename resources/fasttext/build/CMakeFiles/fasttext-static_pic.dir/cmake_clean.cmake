@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/fasttext-static_pic.dir/src/args.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/args.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/autotune.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/autotune.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/densematrix.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/densematrix.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/dictionary.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/dictionary.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/fasttext.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/fasttext.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/halfmatrix.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/halfmatrix.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/int8matrix.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/int8matrix.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/loss.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/loss.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/main.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/main.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/matrix.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/matrix.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/meter.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/meter.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/model.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/model.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/productquantizer.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/productquantizer.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/quantmatrix.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/quantmatrix.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/utils.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/utils.cc.o.d"
+  "CMakeFiles/fasttext-static_pic.dir/src/vector.cc.o"
+  "CMakeFiles/fasttext-static_pic.dir/src/vector.cc.o.d"
+  "libfasttext_pic.a"
+  "libfasttext_pic.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/fasttext-static_pic.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
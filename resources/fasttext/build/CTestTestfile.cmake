@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/resources/fasttext
+# Build directory: /root/repo/resources/fasttext/build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(model "/root/repo/resources/fasttext/build/fasttext-model-test" "/root/repo/resources/fasttext/build")
+set_tests_properties(model PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/resources/fasttext/CMakeLists.txt;80;add_test;/root/repo/resources/fasttext/CMakeLists.txt;0;")
@@ -116,6 +116,7 @@ PYBIND11_MODULE(fasttext_pybind, m) {
       .def_readwrite("qnorm", &fasttext::Args::qnorm)
       .def_readwrite("cutoff", &fasttext::Args::cutoff)
       .def_readwrite("dsub", &fasttext::Args::dsub)
+      .def_readwrite("qint8", &fasttext::Args::qint8)
 
       .def_readwrite(
           "autotuneValidationFile", &fasttext::Args::autotuneValidationFile)
@@ -190,7 +191,7 @@ PYBIND11_MODULE(fasttext_pybind, m) {
             py::format_descriptor<fasttext::real>::format(),
             2,
             {m.size(0), m.size(1)},
-            {sizeof(fasttext::real) * m.size(1),
+            {sizeof(fasttext::real) * m.stride(),
              sizeof(fasttext::real) * (int64_t)1});
       });
 
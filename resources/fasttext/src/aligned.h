@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace fasttext {
+
+// Allocator aligning storage to Alignment bytes, a cache line by default.
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+ public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U, Alignment> other;
+  };
+
+  AlignedAllocator() noexcept {}
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    void* p = nullptr;
+#ifdef _MSC_VER
+    p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+    if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) {
+      p = nullptr;
+    }
+#endif
+    if (p == nullptr && n > 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, std::size_t) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+  }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(
+    const AlignedAllocator<T, Alignment>&,
+    const AlignedAllocator<U, Alignment>&) {
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(
+    const AlignedAllocator<T, Alignment>&,
+    const AlignedAllocator<U, Alignment>&) {
+  return false;
+}
+
+} // namespace fasttext
@@ -45,6 +45,7 @@ Args::Args() {
   qnorm = false;
   cutoff = 0;
   dsub = 2;
+  qint8 = false;
 
   autotuneValidationFile = "";
   autotuneMetric = "f1";
@@ -201,6 +202,9 @@ void Args::parseArgs(const std::vector<std::string>& args) {
         cutoff = std::stoi(args.at(ai + 1));
       } else if (args[ai] == "-dsub") {
         dsub = std::stoi(args.at(ai + 1));
+      } else if (args[ai] == "-qint8") {
+        qint8 = true;
+        ai--;
       } else if (args[ai] == "-autotune-validation") {
         autotuneValidationFile = std::string(args.at(ai + 1));
       } else if (args[ai] == "-autotune-metric") {
@@ -319,7 +323,10 @@ void Args::printQuantizationHelp() {
       << boolToString(qnorm) << "]\n"
       << "  -qout               whether the classifier is quantized ["
       << boolToString(qout) << "]\n"
-      << "  -dsub               size of each sub-vector [" << dsub << "]\n";
+      << "  -dsub               size of each sub-vector [" << dsub << "]\n"
+      << "  -qint8              whether rows are quantized to int8 instead of "
+         "product quantization ["
+      << boolToString(qint8) << "]\n";
 }
 
 void Args::save(std::ostream& out) {
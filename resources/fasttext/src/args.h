@@ -65,6 +65,7 @@ class Args {
   bool qnorm;
   size_t cutoff;
   size_t dsub;
+  bool qint8;
 
   std::string autotuneValidationFile;
   std::string autotuneMetric;
@@ -8,6 +8,7 @@
 
 #include "densematrix.h"
 
+#include <cstring>
 #include <random>
 #include <stdexcept>
 #include <thread>
@@ -19,13 +20,47 @@ namespace fasttext {
 
 DenseMatrix::DenseMatrix() : DenseMatrix(0, 0) {}
 
-DenseMatrix::DenseMatrix(int64_t m, int64_t n) : Matrix(m, n), data_(m * n) {}
+DenseMatrix::DenseMatrix(int64_t m, int64_t n)
+    : Matrix(m, n),
+      data_(m * n),
+      stride_(n),
+      padding_(1),
+      kernels_(kernels::select(n)) {}
 
 DenseMatrix::DenseMatrix(DenseMatrix&& other) noexcept
-    : Matrix(other.m_, other.n_), data_(std::move(other.data_)) {}
+    : Matrix(other.m_, other.n_),
+      data_(std::move(other.data_)),
+      stride_(other.stride_),
+      padding_(other.padding_),
+      kernels_(other.kernels_) {}
 
 DenseMatrix::DenseMatrix(int64_t m, int64_t n, real* dataPtr)
-    : Matrix(m, n), data_(dataPtr, dataPtr + (m * n)) {}
+    : Matrix(m, n),
+      data_(dataPtr, dataPtr + (m * n)),
+      stride_(n),
+      padding_(1),
+      kernels_(kernels::select(n)) {}
+
+// Pads every row to a multiple of `multiple` floats so that, with 16, rows
+// start on a cache line. Applies to the current rows and to later loads;
+// padding with 1 makes the rows contiguous again. Files are never padded.
+void DenseMatrix::padRows(int64_t multiple) {
+  assert(multiple > 0);
+  padding_ = multiple;
+  const int64_t stride = (n_ + multiple - 1) / multiple * multiple;
+  if (stride == stride_) {
+    return;
+  }
+  std::vector<real, AlignedAllocator<real>> data(m_ * stride);
+  for (int64_t i = 0; i < m_; i++) {
+    std::copy(
+        data_.begin() + i * stride_,
+        data_.begin() + i * stride_ + n_,
+        data.begin() + i * stride);
+  }
+  data_.swap(data);
+  stride_ = stride;
+}
 
 void DenseMatrix::zero() {
   std::fill(data_.begin(), data_.end(), 0.0);
@@ -34,9 +69,10 @@ void DenseMatrix::zero() {
 void DenseMatrix::uniformThread(real a, int block, int32_t seed) {
   std::minstd_rand rng(block + seed);
   std::uniform_real_distribution<> uniform(-a, a);
-  int64_t blockSize = (m_ * n_) / 10;
+  int64_t size = data_.size();
+  int64_t blockSize = size / 10;
   for (int64_t i = blockSize * block;
-       i < (m_ * n_) && i < blockSize * (block + 1);
+       i < size && i < blockSize * (block + 1);
        i++) {
     data_[i] = uniform(rng);
   }
@@ -109,22 +145,30 @@ real DenseMatrix::dotRow(const Vector& vec, int64_t i) const {
   assert(i >= 0);
   assert(i < m_);
   assert(vec.size() == n_);
-  real d = 0.0;
-  for (int64_t j = 0; j < n_; j++) {
-    d += at(i, j) * vec[j];
-  }
+  real d = kernels_->dot(data_.data() + i * stride_, vec.data(), n_);
   if (std::isnan(d)) {
     throw EncounteredNaNError();
   }
   return d;
 }
 
+void DenseMatrix::dotRows(const Vector& vec, Vector& out) const {
+  assert(vec.size() == n_);
+  assert(out.size() == m_);
+  kernels_->dots(data_.data(), m_, n_, stride_, vec.data(), out.data());
+  for (int64_t i = 0; i < m_; i++) {
+    if (std::isnan(out[i])) {
+      throw EncounteredNaNError();
+    }
+  }
+}
+
 void DenseMatrix::addVectorToRow(const Vector& vec, int64_t i, real a) {
   assert(i >= 0);
   assert(i < m_);
   assert(vec.size() == n_);
   for (int64_t j = 0; j < n_; j++) {
-    data_[i * n_ + j] += a * vec[j];
+    at(i, j) += a * vec[j];
   }
 }
 
@@ -146,17 +190,45 @@ void DenseMatrix::addRowToVector(Vector& x, int32_t i, real a) const {
   }
 }
 
+void DenseMatrix::addRowsToVector(
+    Vector& x,
+    const int32_t* ids,
+    int64_t count) const {
+  assert(x.size() == n_);
+  kernels_->add(
+      x.data(), data_.data(), n_, stride_, ids, count, prefetchDistance_);
+}
+
+void DenseMatrix::permuteRows(const std::vector<int32_t>& order) {
+  permuteBuffer(data_, stride_, order);
+}
+
 void DenseMatrix::save(std::ostream& out) const {
   out.write((char*)&m_, sizeof(int64_t));
   out.write((char*)&n_, sizeof(int64_t));
-  out.write((char*)data_.data(), m_ * n_ * sizeof(real));
+  if (stride_ == n_) {
+    out.write((char*)data_.data(), m_ * n_ * sizeof(real));
+  } else {
+    for (int64_t i = 0; i < m_; i++) {
+      out.write((char*)&at(i, 0), n_ * sizeof(real));
+    }
+  }
 }
 
 void DenseMatrix::load(std::istream& in) {
   in.read((char*)&m_, sizeof(int64_t));
   in.read((char*)&n_, sizeof(int64_t));
-  data_ = std::vector<real>(m_ * n_);
+  kernels_ = kernels::select(n_);
+  stride_ = (n_ + padding_ - 1) / padding_ * padding_;
+  data_ = std::vector<real, AlignedAllocator<real>>(m_ * stride_);
   in.read((char*)data_.data(), m_ * n_ * sizeof(real));
+  if (stride_ != n_) {
+    // spread the rows read contiguously, from the last one
+    for (int64_t i = m_ - 1; i >= 0; i--) {
+      std::memmove(&at(i, 0), &data_[i * n_], n_ * sizeof(real));
+      std::fill(&at(i, n_), &at(i, 0) + stride_, 0.0);
+    }
+  }
 }
 
 void DenseMatrix::dump(std::ostream& out) const {
@@ -15,6 +15,8 @@
 #include <stdexcept>
 #include <vector>
 
+#include "aligned.h"
+#include "kernels.h"
 #include "matrix.h"
 #include "real.h"
 
@@ -24,7 +26,10 @@ class Vector;
 
 class DenseMatrix : public Matrix {
  protected:
-  std::vector<real> data_;
+  std::vector<real, AlignedAllocator<real>> data_;
+  int64_t stride_;
+  int64_t padding_;
+  const kernels::Kernels* kernels_;
   void uniformThread(real, int, int32_t);
 
  public:
@@ -37,6 +42,7 @@ class DenseMatrix : public Matrix {
   DenseMatrix& operator=(DenseMatrix&&) = delete;
   virtual ~DenseMatrix() noexcept override = default;
 
+  // Rows are stride() floats apart, see padRows().
   inline real* data() {
     return data_.data();
   }
@@ -45,11 +51,11 @@ class DenseMatrix : public Matrix {
   }
 
   inline const real& at(int64_t i, int64_t j) const {
-    assert(i * n_ + j < data_.size());
-    return data_[i * n_ + j];
+    assert(i * stride_ + j < data_.size());
+    return data_[i * stride_ + j];
   };
   inline real& at(int64_t i, int64_t j) {
-    return data_[i * n_ + j];
+    return data_[i * stride_ + j];
   };
 
   inline int64_t rows() const {
@@ -58,6 +64,10 @@ class DenseMatrix : public Matrix {
   inline int64_t cols() const {
     return n_;
   }
+  inline int64_t stride() const {
+    return stride_;
+  }
+  void padRows(int64_t multiple);
   void zero();
   void uniform(real, unsigned int, int32_t);
 
@@ -71,6 +81,10 @@ class DenseMatrix : public Matrix {
   void addVectorToRow(const Vector&, int64_t, real) override;
   void addRowToVector(Vector& x, int32_t i) const override;
   void addRowToVector(Vector& x, int32_t i, real a) const override;
+  void addRowsToVector(Vector& x, const int32_t* ids, int64_t count)
+      const override;
+  void dotRows(const Vector&, Vector& out) const override;
+  void permuteRows(const std::vector<int32_t>& order) override;
   void save(std::ostream&) const override;
   void load(std::istream&) override;
   void dump(std::ostream&) const override;
@@ -12,9 +12,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <numeric>
 #include <stdexcept>
 
 namespace fasttext {
@@ -32,14 +34,17 @@ Dictionary::Dictionary(std::shared_ptr<Args> args)
       ntokens_(0),
       pruneidx_size_(-1) {}
 
-Dictionary::Dictionary(std::shared_ptr<Args> args, std::istream& in)
+Dictionary::Dictionary(
+    std::shared_ptr<Args> args,
+    std::istream& in,
+    bool precompute)
     : args_(args),
       size_(0),
       nwords_(0),
       nlabels_(0),
       ntokens_(0),
       pruneidx_size_(-1) {
-  load(in);
+  load(in, precompute);
 }
 
 int32_t Dictionary::find(const std::string& w) const {
@@ -205,6 +210,14 @@ void Dictionary::initNgrams() {
   }
 }
 
+void Dictionary::initWord2Int() {
+  int32_t word2intsize = std::ceil(size_ / 0.7);
+  word2int_.assign(word2intsize, -1);
+  for (int32_t i = 0; i < size_; i++) {
+    word2int_[find(words_[i].word)] = i;
+  }
+}
+
 bool Dictionary::readWord(std::istream& in, std::string& word) const {
   int c;
   std::streambuf& sb = *in.rdbuf();
@@ -406,6 +419,75 @@ int32_t Dictionary::getLine(
   return ntokens;
 }
 
+// Same ids as the supervised getLine, in chunks and in another order: the
+// word ngrams ending at a word follow its subwords. Only the hashes of the
+// last wordNgrams - 1 words are kept, so memory does not grow with the line.
+// The buffers are kept by the thread between calls.
+int32_t Dictionary::streamLine(std::istream& in, const IdsCallback& callback)
+    const {
+  static thread_local std::vector<int32_t> window;
+  window.clear();
+  return streamLine(in, callback, window);
+}
+
+// Same as above for a line continuing an earlier one: `window` holds the
+// hashes of its last words, which form word ngrams with the first words of
+// this line, and is left with those of this line for the next one.
+int32_t Dictionary::streamLine(
+    std::istream& in,
+    const IdsCallback& callback,
+    std::vector<int32_t>& window) const {
+  static thread_local std::vector<int32_t> ids;
+  static thread_local std::string token;
+  int32_t ntokens = 0;
+  const int32_t n = args_->wordNgrams;
+
+  reset(in);
+  ids.clear();
+  if (n <= 1) {
+    window.clear();
+  } else if (window.size() > static_cast<size_t>(n - 1)) {
+    window.erase(window.begin(), window.end() - (n - 1));
+  }
+  ids.reserve(STREAM_CHUNK_SIZE);
+  while (readWord(in, token)) {
+    uint32_t h = hash(token);
+    int32_t wid = getId(token, h);
+    entry_type type = wid < 0 ? getType(token) : getType(wid);
+
+    ntokens++;
+    if (type == entry_type::word) {
+      addSubwords(ids, token, wid);
+      // ngrams from each word of the window to this one, as addWordNgrams
+      for (int32_t i = 0; i < window.size(); i++) {
+        uint64_t ngram = window[i];
+        for (int32_t j = i + 1; j < window.size(); j++) {
+          ngram = ngram * 116049371 + window[j];
+        }
+        ngram = ngram * 116049371 + int32_t(h);
+        pushHash(ids, ngram % args_->bucket);
+      }
+      if (n > 1) {
+        if (window.size() == n - 1) {
+          window.erase(window.begin());
+        }
+        window.push_back(h);
+      }
+      if (ids.size() >= STREAM_CHUNK_SIZE) {
+        callback(ids.data(), ids.size());
+        ids.clear();
+      }
+    }
+    if (token == EOS) {
+      break;
+    }
+  }
+  if (!ids.empty()) {
+    callback(ids.data(), ids.size());
+  }
+  return ntokens;
+}
+
 void Dictionary::pushHash(std::vector<int32_t>& hashes, int32_t id) const {
   if (pruneidx_size_ == 0 || id < 0) {
     return;
@@ -447,38 +529,121 @@ void Dictionary::save(std::ostream& out) const {
   }
 }
 
-void Dictionary::load(std::istream& in) {
+void Dictionary::load(std::istream& in, bool precompute) {
   words_.clear();
   in.read((char*)&size_, sizeof(int32_t));
   in.read((char*)&nwords_, sizeof(int32_t));
   in.read((char*)&nlabels_, sizeof(int32_t));
   in.read((char*)&ntokens_, sizeof(int64_t));
   in.read((char*)&pruneidx_size_, sizeof(int64_t));
+  words_.resize(size_);
+  char tail[sizeof(int64_t) + sizeof(entry_type)];
   for (int32_t i = 0; i < size_; i++) {
-    char c;
-    entry e;
-    while ((c = in.get()) != 0) {
-      e.word.push_back(c);
-    }
-    in.read((char*)&e.count, sizeof(int64_t));
-    in.read((char*)&e.type, sizeof(entry_type));
-    words_.push_back(e);
+    entry& e = words_[i];
+    // getline scans the stream buffer in blocks instead of calling get()
+    // once per character.
+    std::getline(in, e.word, '\0');
+    in.read(tail, sizeof(tail));
+    memcpy(&e.count, tail, sizeof(int64_t));
+    memcpy(&e.type, tail + sizeof(int64_t), sizeof(entry_type));
   }
   pruneidx_.clear();
-  for (int32_t i = 0; i < pruneidx_size_; i++) {
-    int32_t first;
-    int32_t second;
-    in.read((char*)&first, sizeof(int32_t));
-    in.read((char*)&second, sizeof(int32_t));
-    pruneidx_[first] = second;
+  if (pruneidx_size_ > 0) {
+    std::vector<int32_t> pairs(2 * pruneidx_size_);
+    in.read((char*)pairs.data(), pairs.size() * sizeof(int32_t));
+    pruneidx_.reserve(pruneidx_size_);
+    for (int64_t i = 0; i < pruneidx_size_; i++) {
+      pruneidx_[pairs[2 * i]] = pairs[2 * i + 1];
+    }
+  }
+  if (!in) {
+    throw std::invalid_argument("Invalid dictionary section.");
   }
   initTableDiscard();
+  if (precompute) {
+    this->precompute();
+  }
+}
+
+// Subword lists and the word2int_ table only depend on the entries, the
+// pruning map and the arguments, so they can be stored alongside the model
+// and loaded back instead of being recomputed (see loadPrecomputed).
+void Dictionary::precompute() {
   initNgrams();
+  initWord2Int();
+}
 
-  int32_t word2intsize = std::ceil(size_ / 0.7);
-  word2int_.assign(word2intsize, -1);
+void Dictionary::savePrecomputed(std::ostream& out) const {
+  int64_t word2intsize = word2int_.size();
+  out.write((char*)&word2intsize, sizeof(int64_t));
+  out.write((char*)word2int_.data(), word2intsize * sizeof(int32_t));
+  std::vector<int32_t> nsubwords(size_);
+  int64_t total = 0;
   for (int32_t i = 0; i < size_; i++) {
-    word2int_[find(words_[i].word)] = i;
+    nsubwords[i] = words_[i].subwords.size();
+    total += nsubwords[i];
+  }
+  out.write((char*)&total, sizeof(int64_t));
+  out.write((char*)nsubwords.data(), size_ * sizeof(int32_t));
+  for (int32_t i = 0; i < size_; i++) {
+    const std::vector<int32_t>& subwords = words_[i].subwords;
+    out.write((char*)subwords.data(), subwords.size() * sizeof(int32_t));
+  }
+}
+
+// The tables are checked against the entries read before them, so that a
+// corrupt section cannot index past words_ or the input matrix.
+void Dictionary::loadPrecomputed(std::istream& in) {
+  int64_t word2intsize;
+  in.read((char*)&word2intsize, sizeof(int64_t));
+  if (!in || word2intsize < size_ ||
+      word2intsize > std::max<int64_t>(MAX_VOCAB_SIZE, size_ / 0.7 + 1)) {
+    throw std::invalid_argument("Invalid precomputed dictionary section.");
+  }
+  word2int_.resize(word2intsize);
+  in.read((char*)word2int_.data(), word2intsize * sizeof(int32_t));
+  for (const auto id : word2int_) {
+    if (id < -1 || id >= size_) {
+      throw std::invalid_argument("Invalid precomputed dictionary section.");
+    }
+  }
+  int64_t total;
+  in.read((char*)&total, sizeof(int64_t));
+  std::vector<int32_t> nsubwords(size_);
+  in.read((char*)nsubwords.data(), size_ * sizeof(int32_t));
+  if (!in) {
+    throw std::invalid_argument("Invalid precomputed dictionary section.");
+  }
+  // a word has itself and at most maxn character ngrams per position of
+  // BOW + word + EOW, so total is bounded before it is allocated
+  int64_t expected = 0;
+  for (int32_t i = 0; i < size_; i++) {
+    const int64_t maxSubwords =
+        1 + (words_[i].word.size() + 2) * std::max(args_->maxn, 0);
+    if (nsubwords[i] < 0 || nsubwords[i] > maxSubwords) {
+      throw std::invalid_argument("Invalid precomputed dictionary section.");
+    }
+    expected += nsubwords[i];
+  }
+  if (total != expected) {
+    throw std::invalid_argument("Invalid precomputed dictionary section.");
+  }
+  std::vector<int32_t> subwords(total);
+  in.read((char*)subwords.data(), total * sizeof(int32_t));
+  const int64_t nids = std::max<int64_t>(
+      size_, nwords_ + (pruneidx_size_ >= 0 ? pruneidx_size_ : args_->bucket));
+  for (const auto id : subwords) {
+    if (id < 0 || id >= nids) {
+      throw std::invalid_argument("Invalid precomputed dictionary section.");
+    }
+  }
+  const int32_t* it = subwords.data();
+  for (int32_t i = 0; i < size_; i++) {
+    words_[i].subwords.assign(it, it + nsubwords[i]);
+    it += nsubwords[i];
+  }
+  if (!in) {
+    throw std::invalid_argument("Invalid precomputed dictionary section.");
   }
 }
 
@@ -499,10 +664,17 @@ void Dictionary::prune(std::vector<int32_t>& idx) {
   std::sort(words.begin(), words.end());
   idx = words;
 
+  // rows of a pruned dictionary are mapped back to their buckets
+  std::vector<int32_t> buckets(std::max(pruneidx_size_, int64_t(0)));
+  for (const auto& it : pruneidx_) {
+    buckets[it.second] = it.first;
+  }
+  pruneidx_.clear();
   if (ngrams.size() != 0) {
     int32_t j = 0;
     for (const auto ngram : ngrams) {
-      pruneidx_[ngram - nwords_] = j;
+      int32_t bucket = ngram - nwords_;
+      pruneidx_[buckets.empty() ? bucket : buckets[bucket]] = j;
       j++;
     }
     idx.insert(idx.end(), ngrams.begin(), ngrams.end());
@@ -526,6 +698,46 @@ void Dictionary::prune(std::vector<int32_t>& idx) {
   initNgrams();
 }
 
+// Renumbers the words, and the ngram buckets of a pruned dictionary, by
+// decreasing row count, ties keeping their current order. Unpruned buckets
+// are addressed by hash and keep their rows. Returns the former row of each
+// new row.
+std::vector<int32_t> Dictionary::reorder(const std::vector<int64_t>& counts) {
+  auto byCount = [&counts](int32_t a, int32_t b) {
+    return counts[a] > counts[b];
+  };
+  std::vector<int32_t> order(nwords_);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), byCount);
+
+  std::vector<entry> words;
+  words.reserve(size_);
+  for (const auto i : order) {
+    words.push_back(words_[i]);
+  }
+  words.insert(words.end(), words_.begin() + nwords_, words_.end());
+  words_.swap(words);
+
+  int64_t nbuckets = pruneidx_size_ >= 0 ? pruneidx_size_ : args_->bucket;
+  std::vector<int32_t> buckets(nbuckets);
+  std::iota(buckets.begin(), buckets.end(), nwords_);
+  if (pruneidx_size_ > 0) {
+    std::stable_sort(buckets.begin(), buckets.end(), byCount);
+    std::vector<int32_t> rank(nbuckets);
+    for (int64_t i = 0; i < nbuckets; i++) {
+      rank[buckets[i] - nwords_] = i;
+    }
+    for (auto& it : pruneidx_) {
+      it.second = rank[it.second];
+    }
+  }
+  order.insert(order.end(), buckets.begin(), buckets.end());
+
+  initWord2Int();
+  initNgrams();
+  return order;
+}
+
 void Dictionary::dump(std::ostream& out) const {
   out << words_.size() << std::endl;
   for (auto it : words_) {
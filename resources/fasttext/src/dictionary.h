@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <istream>
 #include <memory>
 #include <ostream>
@@ -32,14 +33,19 @@ struct entry {
 };
 
 class Dictionary {
+ public:
+  using IdsCallback = std::function<void(const int32_t*, int32_t)>;
+
  protected:
   static const int32_t MAX_VOCAB_SIZE = 30000000;
   static const int32_t MAX_LINE_SIZE = 1024;
+  static const int32_t STREAM_CHUNK_SIZE = 256;
 
   int32_t find(const std::string&) const;
   int32_t find(const std::string&, uint32_t h) const;
   void initTableDiscard();
   void initNgrams();
+  void initWord2Int();
   void reset(std::istream&) const;
   void pushHash(std::vector<int32_t>&, int32_t) const;
   void addSubwords(std::vector<int32_t>&, const std::string&, int32_t) const;
@@ -67,7 +73,10 @@ class Dictionary {
   static const std::string EOW;
 
   explicit Dictionary(std::shared_ptr<Args>);
-  explicit Dictionary(std::shared_ptr<Args>, std::istream&);
+  explicit Dictionary(
+      std::shared_ptr<Args>,
+      std::istream&,
+      bool precompute = true);
   int32_t nwords() const;
   int32_t nlabels() const;
   int64_t ntokens() const;
@@ -93,15 +102,24 @@ class Dictionary {
   void readFromFile(std::istream&);
   std::string getLabel(int32_t) const;
   void save(std::ostream&) const;
-  void load(std::istream&);
+  void load(std::istream&, bool precompute = true);
+  void precompute();
+  void savePrecomputed(std::ostream&) const;
+  void loadPrecomputed(std::istream&);
   std::vector<int64_t> getCounts(entry_type) const;
   int32_t getLine(std::istream&, std::vector<int32_t>&, std::vector<int32_t>&)
       const;
   int32_t getLine(std::istream&, std::vector<int32_t>&, std::minstd_rand&)
       const;
+  int32_t streamLine(std::istream&, const IdsCallback&) const;
+  int32_t streamLine(
+      std::istream&,
+      const IdsCallback&,
+      std::vector<int32_t>& window) const;
   void threshold(int64_t, int64_t);
   void prune(std::vector<int32_t>&);
-  bool isPruned() {
+  std::vector<int32_t> reorder(const std::vector<int64_t>&);
+  bool isPruned() const {
     return pruneidx_size_ >= 0;
   }
   void dump(std::ostream&) const;
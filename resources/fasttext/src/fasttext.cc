@@ -8,6 +8,8 @@
 
 #include "fasttext.h"
 #include "loss.h"
+#include "halfmatrix.h"
+#include "int8matrix.h"
 #include "quantmatrix.h"
 
 #include <algorithm>
@@ -22,8 +24,81 @@
 
 namespace fasttext {
 
-constexpr int32_t FASTTEXT_VERSION = 12; /* Version 1b */
+constexpr int32_t FASTTEXT_VERSION = 13; /* Version 1c */
+// Models that stock fastText can read are still written as version 12.
+constexpr int32_t FASTTEXT_COMPATIBLE_VERSION = 12; /* Version 1b */
 constexpr int32_t FASTTEXT_FILEFORMAT_MAGIC_INT32 = 793712314;
+constexpr int32_t FASTTEXT_PRECOMPUTED_MAGIC_INT32 = 793712315;
+constexpr int64_t FASTTEXT_ROW_PADDING = 16; /* floats, a cache line */
+
+// Adds to `counts` how many times the lines of `in` use each input row.
+void FastText::countRows(std::istream& in, std::vector<int64_t>& counts)
+    const {
+  counts.resize(input_->size(0), 0);
+  std::vector<int32_t> line, labels;
+  while (in.peek() != EOF) {
+    line.clear();
+    labels.clear();
+    dict_->getLine(in, line, labels);
+    for (const auto id : line) {
+      counts[id]++;
+    }
+  }
+}
+
+// Renumbers the input rows by how often the lines of `in` use them, so that
+// the rows of common text are stored next to each other. Returns the share
+// of the row uses of `in` whose rows were moved: the buckets of a model that
+// is not pruned keep their place, as their ids are hashes.
+double FastText::reorderRows(std::istream& in) {
+  if (args_->model != model_name::sup) {
+    throw std::invalid_argument("Only supervised models can be reordered.");
+  }
+  std::vector<int64_t> counts;
+  countRows(in, counts);
+  int64_t total = 0, moved = 0;
+  for (int64_t i = 0; i < counts.size(); i++) {
+    total += counts[i];
+    if (i < dict_->nwords() || dict_->isPruned()) {
+      moved += counts[i];
+    }
+  }
+  input_->permuteRows(dict_->reorder(counts));
+  return total > 0 ? double(moved) / total : 1.0;
+}
+
+// Keeps the input rows used at least `minCount` times, and end of sentence.
+void FastText::pruneRows(const std::vector<int64_t>& counts, int64_t minCount) {
+  if (args_->model != model_name::sup) {
+    throw std::invalid_argument("Only supervised models can be pruned.");
+  }
+  if (inputType_ != matrix_type::dense) {
+    throw std::invalid_argument("Only dense models can be pruned.");
+  }
+  std::shared_ptr<DenseMatrix> input =
+      std::dynamic_pointer_cast<DenseMatrix>(input_);
+  if (counts.size() != input->size(0)) {
+    throw std::invalid_argument(
+        "Row counts do not match the input matrix of the model.");
+  }
+  auto eosid = dict_->getId(Dictionary::EOS);
+  std::vector<int32_t> idx;
+  for (int32_t i = 0; i < input->size(0); i++) {
+    if (counts[i] >= minCount || i == eosid) {
+      idx.push_back(i);
+    }
+  }
+  dict_->prune(idx);
+  std::shared_ptr<DenseMatrix> ninput =
+      std::make_shared<DenseMatrix>(idx.size(), args_->dim);
+  for (auto i = 0; i < idx.size(); i++) {
+    for (auto j = 0; j < args_->dim; j++) {
+      ninput->at(i, j) = input->at(idx[i], j);
+    }
+  }
+  input_ = ninput;
+  buildModel();
+}
 
 bool comparePairs(
     const std::pair<real, std::string>& l,
@@ -48,7 +123,13 @@ std::shared_ptr<Loss> FastText::createLoss(std::shared_ptr<Matrix>& output) {
 }
 
 FastText::FastText()
-    : quant_(false), wordVectors_(nullptr), trainException_(nullptr) {}
+    : inputType_(matrix_type::dense),
+      precomputed_(false),
+      padRows_(false),
+      prefetchDistance_(-1),
+      foldDuplicates_(false),
+      wordVectors_(nullptr),
+      trainException_(nullptr) {}
 
 void FastText::addInputVector(Vector& vec, int32_t ind) const {
   vec.addRow(*input_, ind);
@@ -63,9 +144,12 @@ const Args FastText::getArgs() const {
 }
 
 std::shared_ptr<const DenseMatrix> FastText::getInputMatrix() const {
-  if (quant_) {
+  if (isQuant()) {
     throw std::runtime_error("Can't export quantized matrix");
   }
+  if (inputType_ == matrix_type::half) {
+    throw std::runtime_error("Can't export half precision matrix");
+  }
   assert(input_.get());
   return std::dynamic_pointer_cast<DenseMatrix>(input_);
 }
@@ -84,7 +168,7 @@ void FastText::setMatrices(
 }
 
 std::shared_ptr<const DenseMatrix> FastText::getOutputMatrix() const {
-  if (quant_ && args_->qout) {
+  if (isQuant() && args_->qout) {
     throw std::runtime_error("Can't export quantized matrix");
   }
   assert(output_.get());
@@ -151,7 +235,7 @@ void FastText::saveOutput(const std::string& filename) {
     throw std::invalid_argument(
         filename + " cannot be opened for saving vectors!");
   }
-  if (quant_) {
+  if (isQuant()) {
     throw std::invalid_argument(
         "Option -saveOutput is not supported for quantized models.");
   }
@@ -182,9 +266,19 @@ bool FastText::checkModel(std::istream& in) {
   return true;
 }
 
+// Version 13 is needed only by half and int8 input matrices, whose type tag
+// is not a bool, and by pruned dense models.
+int32_t FastText::fileVersion() const {
+  if (inputType_ == matrix_type::half || inputType_ == matrix_type::int8 ||
+      (!isQuant() && dict_->isPruned())) {
+    return FASTTEXT_VERSION;
+  }
+  return FASTTEXT_COMPATIBLE_VERSION;
+}
+
 void FastText::signModel(std::ostream& out) {
   const int32_t magic = FASTTEXT_FILEFORMAT_MAGIC_INT32;
-  const int32_t version = FASTTEXT_VERSION;
+  const int32_t version = fileVersion();
   out.write((char*)&(magic), sizeof(int32_t));
   out.write((char*)&(version), sizeof(int32_t));
 }
@@ -201,15 +295,50 @@ void FastText::saveModel(const std::string& filename) {
   args_->save(ofs);
   dict_->save(ofs);
 
-  ofs.write((char*)&(quant_), sizeof(bool));
+  ofs.write((char*)&(inputType_), sizeof(matrix_type));
   input_->save(ofs);
 
   ofs.write((char*)&(args_->qout), sizeof(bool));
   output_->save(ofs);
 
+  if (precomputed_) {
+    // Optional trailing section, ignored by readers that do not know it.
+    const int32_t magic = FASTTEXT_PRECOMPUTED_MAGIC_INT32;
+    ofs.write((char*)&(magic), sizeof(int32_t));
+    dict_->savePrecomputed(ofs);
+  }
+
   ofs.close();
 }
 
+void FastText::setPrecomputed(bool precomputed) {
+  precomputed_ = precomputed;
+}
+
+bool FastText::isPrecomputed() const {
+  return precomputed_;
+}
+
+void FastText::setPadRows(bool padRows) {
+  padRows_ = padRows;
+}
+
+// Also applies to models loaded later, a negative distance keeps the default.
+void FastText::setPrefetchDistance(int32_t distance) {
+  prefetchDistance_ = distance;
+  if (input_ && distance >= 0) {
+    input_->setPrefetchDistance(distance);
+  }
+}
+
+// For predictions of the current and later loaded models.
+void FastText::setFoldDuplicates(bool foldDuplicates) {
+  foldDuplicates_ = foldDuplicates;
+  if (model_) {
+    model_->setFoldDuplicates(foldDuplicates);
+  }
+}
+
 void FastText::loadModel(const std::string& filename) {
   std::ifstream ifs(filename, std::ifstream::binary);
   if (!ifs.is_open()) {
@@ -234,28 +363,63 @@ void FastText::buildModel() {
   auto loss = createLoss(output_);
   bool normalizeGradient = (args_->model == model_name::sup);
   model_ = std::make_shared<Model>(input_, output_, loss, normalizeGradient);
+  model_->setFoldDuplicates(foldDuplicates_);
 }
 
 void FastText::loadModel(std::istream& in) {
+  auto start = std::chrono::steady_clock::now();
+  auto lap = [&start]() {
+    auto now = std::chrono::steady_clock::now();
+    double duration = utils::getDuration(start, now);
+    start = now;
+    return duration;
+  };
+  loadProfile_ = LoadProfile();
+
   args_ = std::make_shared<Args>();
-  input_ = std::make_shared<DenseMatrix>();
-  output_ = std::make_shared<DenseMatrix>();
+  auto input = std::make_shared<DenseMatrix>();
+  auto output = std::make_shared<DenseMatrix>();
+  if (padRows_) {
+    // on-disk rows stay contiguous, the padding is added while loading
+    input->padRows(FASTTEXT_ROW_PADDING);
+    output->padRows(FASTTEXT_ROW_PADDING);
+  }
+  input_ = input;
+  output_ = output;
   args_->load(in);
   if (version == 11 && args_->model == model_name::sup) {
     // backward compatibility: old supervised models do not use char ngrams.
     args_->maxn = 0;
   }
-  dict_ = std::make_shared<Dictionary>(args_, in);
-
-  bool quant_input;
-  in.read((char*)&quant_input, sizeof(bool));
-  if (quant_input) {
-    quant_ = true;
-    input_ = std::make_shared<QuantMatrix>();
+  loadProfile_.args = lap();
+  dict_ = std::make_shared<Dictionary>(args_, in, false);
+  loadProfile_.dictionary = lap();
+
+  // a bool quantization flag up to version 12
+  in.read((char*)&inputType_, sizeof(matrix_type));
+  switch (inputType_) {
+    case matrix_type::dense:
+      break;
+    case matrix_type::quant:
+      input_ = std::make_shared<QuantMatrix>();
+      break;
+    case matrix_type::half:
+      input_ = std::make_shared<HalfMatrix>();
+      break;
+    case matrix_type::int8:
+      input_ = std::make_shared<Int8Matrix>();
+      break;
+    default:
+      throw std::invalid_argument("Unknown input matrix type.");
   }
   input_->load(in);
+  if (prefetchDistance_ >= 0) {
+    input_->setPrefetchDistance(prefetchDistance_);
+  }
+  loadProfile_.input = lap();
 
-  if (!quant_input && dict_->isPruned()) {
+  // pruned dense models are written since version 13
+  if (!isQuant() && dict_->isPruned() && version < 13) {
     throw std::invalid_argument(
         "Invalid model file.\n"
         "Please download the updated model from www.fasttext.cc.\n"
@@ -263,14 +427,32 @@ void FastText::loadModel(std::istream& in) {
   }
 
   in.read((char*)&args_->qout, sizeof(bool));
-  if (quant_ && args_->qout) {
+  if (inputType_ == matrix_type::quant && args_->qout) {
     output_ = std::make_shared<QuantMatrix>();
+  } else if (inputType_ == matrix_type::int8 && args_->qout) {
+    output_ = std::make_shared<Int8Matrix>();
   }
   output_->load(in);
+  loadProfile_.output = lap();
+
+  int32_t magic;
+  precomputed_ = in.read((char*)&(magic), sizeof(int32_t)) &&
+      magic == FASTTEXT_PRECOMPUTED_MAGIC_INT32;
+  if (precomputed_) {
+    dict_->loadPrecomputed(in);
+  } else {
+    in.clear();
+    dict_->precompute();
+  }
+  loadProfile_.dictionary += lap();
 
   buildModel();
 }
 
+const FastText::LoadProfile& FastText::getLoadProfile() const {
+  return loadProfile_;
+}
+
 std::tuple<int64_t, double, double> FastText::progressInfo(real progress) {
   double t = utils::getDuration(start_, std::chrono::steady_clock::now());
   double lr = args_->lr * (1.0 - progress);
@@ -325,6 +507,9 @@ void FastText::quantize(const Args& qargs, const TrainCallback& callback) {
     throw std::invalid_argument(
         "For now we only support quantization of supervised models");
   }
+  if (inputType_ != matrix_type::dense) {
+    throw std::invalid_argument("Only dense models can be quantized.");
+  }
   args_->input = qargs.input;
   args_->qout = qargs.qout;
   args_->output = qargs.output;
@@ -355,14 +540,21 @@ void FastText::quantize(const Args& qargs, const TrainCallback& callback) {
       startThreads(callback);
     }
   }
-  input_ = std::make_shared<QuantMatrix>(
-      std::move(*(input.get())), qargs.dsub, qargs.qnorm);
-
-  if (args_->qout) {
-    output_ = std::make_shared<QuantMatrix>(
-        std::move(*(output.get())), 2, qargs.qnorm);
+  if (qargs.qint8) {
+    input_ = std::make_shared<Int8Matrix>(*input);
+    if (args_->qout) {
+      output_ = std::make_shared<Int8Matrix>(*output);
+    }
+    inputType_ = matrix_type::int8;
+  } else {
+    input_ = std::make_shared<QuantMatrix>(
+        std::move(*(input.get())), qargs.dsub, qargs.qnorm);
+    if (args_->qout) {
+      output_ = std::make_shared<QuantMatrix>(
+          std::move(*(output.get())), 2, qargs.qnorm);
+    }
+    inputType_ = matrix_type::quant;
   }
-  quant_ = true;
   auto loss = createLoss(output_);
   model_ = std::make_shared<Model>(input_, output_, loss, normalizeGradient);
 }
@@ -471,14 +663,95 @@ bool FastText::predictLine(
     int32_t k,
     real threshold) const {
   predictions.clear();
+  Predictions linePredictions;
+  if (!predictLine(in, linePredictions, k, threshold)) {
+    return false;
+  }
+  for (const auto& p : linePredictions) {
+    predictions.push_back(std::make_pair(p.first, dict_->getLabel(p.second)));
+  }
+
+  return true;
+}
+
+// Probabilities with the ids of the labels, see Dictionary::getLabel.
+bool FastText::predictLine(
+    std::istream& in,
+    Predictions& predictions,
+    int32_t k,
+    real threshold) const {
+  predictions.clear();
   if (in.peek() == EOF) {
     return false;
   }
 
   std::vector<int32_t> words, labels;
   dict_->getLine(in, words, labels);
+  predict(k, words, predictions, threshold);
+  for (auto& p : predictions) {
+    p.first = std::exp(p.first);
+  }
+
+  return true;
+}
+
+// Ids of `labels` for the predictions restricted to them. Throws if a label
+// is unknown or given more than once.
+std::vector<int32_t> FastText::getLabelIds(
+    const std::vector<std::string>& labels) const {
+  std::vector<int32_t> ids;
+  std::vector<bool> seen(dict_->nlabels(), false);
+  for (const auto& label : labels) {
+    int32_t id = dict_->getId(label);
+    if (id < 0 || dict_->getType(id) != entry_type::label) {
+      throw std::invalid_argument(label + " is not a label of the model.");
+    }
+    id -= dict_->nwords();
+    // a label given twice would be counted twice by the softmax
+    if (seen[id]) {
+      throw std::invalid_argument(label + " is given more than once.");
+    }
+    seen[id] = true;
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+// Scores only the given label ids. Returns the probability of all other
+// labels together, or -1 when the loss cannot tell it (softmax predictions
+// are normalized over `labels`, one-vs-all scores are independent).
+real FastText::predict(
+    int32_t k,
+    const std::vector<int32_t>& words,
+    const std::vector<int32_t>& labels,
+    Predictions& predictions,
+    real threshold) const {
+  if (words.empty()) {
+    return -1.0;
+  }
+  Model::State state(args_->dim, dict_->nlabels(), 0);
+  if (args_->model != model_name::sup) {
+    throw std::invalid_argument("Model needs to be supervised for prediction!");
+  }
+  return model_->predict(words, labels, k, threshold, predictions, state);
+}
+
+bool FastText::predictLine(
+    std::istream& in,
+    std::vector<std::pair<real, std::string>>& predictions,
+    const std::vector<int32_t>& labels,
+    real& rest,
+    int32_t k,
+    real threshold) const {
+  predictions.clear();
+  if (in.peek() == EOF) {
+    return false;
+  }
+
+  std::vector<int32_t> words, labelIds;
+  dict_->getLine(in, words, labelIds);
   Predictions linePredictions;
-  predict(k, words, linePredictions, threshold);
+  rest = predict(k, words, labels, linePredictions, threshold);
   for (const auto& p : linePredictions) {
     predictions.push_back(
         std::make_pair(std::exp(p.first), dict_->getLabel(p.second)));
@@ -487,6 +760,127 @@ bool FastText::predictLine(
   return true;
 }
 
+// Adds the input rows of the ids of a line to `sum` as they are read,
+// returns the number of rows added.
+int64_t FastText::addLineToVector(std::istream& in, Vector& sum) const {
+  int64_t count = 0;
+  dict_->streamLine(in, [&](const int32_t* ids, int32_t n) {
+    input_->addRowsToVector(sum, ids, n);
+    count += n;
+  });
+  return count;
+}
+
+// Same as above for a line continuing an earlier one, see
+// Dictionary::streamLine; `window` carries the word ngrams across lines.
+int64_t FastText::addLineToVector(
+    std::istream& in,
+    Vector& sum,
+    std::vector<int32_t>& window) const {
+  int64_t count = 0;
+  dict_->streamLine(
+      in,
+      [&](const int32_t* ids, int32_t n) {
+        input_->addRowsToVector(sum, ids, n);
+        count += n;
+      },
+      window);
+  return count;
+}
+
+void FastText::predict(
+    int32_t k,
+    const Vector& sum,
+    int64_t count,
+    Predictions& predictions,
+    real threshold) const {
+  if (count == 0) {
+    return;
+  }
+  Model::State state(args_->dim, dict_->nlabels(), 0);
+  if (args_->model != model_name::sup) {
+    throw std::invalid_argument("Model needs to be supervised for prediction!");
+  }
+  model_->predict(sum, count, k, threshold, predictions, state);
+}
+
+// Same as predictLine, without materializing the ids of the line.
+bool FastText::predictLineStreamed(
+    std::istream& in,
+    std::vector<std::pair<real, std::string>>& predictions,
+    int32_t k,
+    real threshold) const {
+  predictions.clear();
+  Predictions linePredictions;
+  if (!predictLineStreamed(in, linePredictions, k, threshold)) {
+    return false;
+  }
+  for (const auto& p : linePredictions) {
+    predictions.push_back(std::make_pair(p.first, dict_->getLabel(p.second)));
+  }
+
+  return true;
+}
+
+bool FastText::predictLineStreamed(
+    std::istream& in,
+    Predictions& predictions,
+    int32_t k,
+    real threshold) const {
+  predictions.clear();
+  if (in.peek() == EOF) {
+    return false;
+  }
+
+  Vector sum(args_->dim);
+  sum.zero();
+  int64_t count = addLineToVector(in, sum);
+  predict(k, sum, count, predictions, threshold);
+  for (auto& p : predictions) {
+    p.first = std::exp(p.first);
+  }
+
+  return true;
+}
+
+// Probabilities of all labels for the sum of `count` input rows, indexed by
+// label id. Returns false if no row was added.
+bool FastText::predictDistribution(
+    const Vector& sum,
+    int64_t count,
+    Vector& probabilities) const {
+  assert(probabilities.size() == dict_->nlabels());
+  if (args_->model != model_name::sup) {
+    throw std::invalid_argument("Model needs to be supervised for prediction!");
+  }
+  if (count == 0) {
+    return false;
+  }
+  // the state is kept per thread and reallocated only for another dimension;
+  // `probabilities` is lent to it as output, which avoids a copy
+  static thread_local Model::State state(0, 0, 0);
+  if (state.hidden.size() != args_->dim) {
+    state = Model::State(args_->dim, 0, 0);
+  }
+  std::swap(state.output, probabilities);
+  model_->predictDistribution(sum, count, state);
+  std::swap(state.output, probabilities);
+  return true;
+}
+
+// Probabilities of all labels, indexed by label id, without ranking them.
+// Returns false if the line has no token of the model.
+bool FastText::predictLineDistribution(std::istream& in, Vector& probabilities)
+    const {
+  static thread_local Vector sum(0);
+  if (sum.size() != args_->dim) {
+    sum = Vector(args_->dim);
+  }
+  sum.zero();
+  int64_t count = addLineToVector(in, sum);
+  return predictDistribution(sum, count, probabilities);
+}
+
 void FastText::getSentenceVector(std::istream& in, fasttext::Vector& svec) {
   svec.zero();
   if (args_->model == model_name::sup) {
@@ -754,6 +1148,7 @@ void FastText::train(const Args& args, const TrainCallback& callback) {
   }
   dict_->readFromFile(ifs);
   ifs.close();
+  precomputed_ = false;
 
   if (!args_->pretrainedVectors.empty()) {
     input_ = getInputMatrixFromFile(args_->pretrainedVectors);
@@ -761,7 +1156,7 @@ void FastText::train(const Args& args, const TrainCallback& callback) {
     input_ = createRandomMatrix();
   }
   output_ = createTrainOutputMatrix();
-  quant_ = false;
+  inputType_ = matrix_type::dense;
   auto loss = createLoss(output_);
   bool normalizeGradient = (args_->model == model_name::sup);
   model_ = std::make_shared<Model>(input_, output_, loss, normalizeGradient);
@@ -820,7 +1215,23 @@ int FastText::getDimension() const {
 }
 
 bool FastText::isQuant() const {
-  return quant_;
+  return inputType_ == matrix_type::quant || inputType_ == matrix_type::int8;
+}
+
+matrix_type FastText::getInputMatrixType() const {
+  return inputType_;
+}
+
+void FastText::convertToHalf() {
+  if (inputType_ != matrix_type::dense) {
+    throw std::invalid_argument(
+        "Only dense models can be converted to half precision.");
+  }
+  std::shared_ptr<DenseMatrix> input =
+      std::dynamic_pointer_cast<DenseMatrix>(input_);
+  input_ = std::make_shared<HalfMatrix>(*input);
+  inputType_ = matrix_type::half;
+  buildModel();
 }
 
 bool comparePairs(
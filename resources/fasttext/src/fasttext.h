@@ -36,6 +36,14 @@ class FastText {
   using TrainCallback =
       std::function<void(float, float, double, double, int64_t)>;
 
+  // Wall-clock seconds spent in each section of the last loadModel call.
+  struct LoadProfile {
+    double args = 0.0;
+    double dictionary = 0.0;
+    double input = 0.0;
+    double output = 0.0;
+  };
+
  protected:
   std::shared_ptr<Args> args_;
   std::shared_ptr<Dictionary> dict_;
@@ -45,11 +53,17 @@ class FastText {
   std::atomic<int64_t> tokenCount_{};
   std::atomic<real> loss_{};
   std::chrono::steady_clock::time_point start_;
-  bool quant_;
+  matrix_type inputType_;
+  bool precomputed_;
+  bool padRows_;
+  int32_t prefetchDistance_;
+  bool foldDuplicates_;
   int32_t version;
   std::unique_ptr<DenseMatrix> wordVectors_;
   std::exception_ptr trainException_;
+  LoadProfile loadProfile_;
 
+  int32_t fileVersion() const;
   void signModel(std::ostream&);
   bool checkModel(std::istream&);
   void startThreads(const TrainCallback& callback = {});
@@ -114,6 +128,20 @@ class FastText {
 
   void saveModel(const std::string& filename);
 
+  void setPrecomputed(bool precomputed);
+
+  bool isPrecomputed() const;
+
+  void setPadRows(bool);
+
+  // Software prefetch distance of the input rows of the current and later
+  // loaded models, off by default, see Matrix::setPrefetchDistance.
+  void setPrefetchDistance(int32_t);
+
+  void setFoldDuplicates(bool);
+
+  const LoadProfile& getLoadProfile() const;
+
   void saveOutput(const std::string& filename);
 
   void loadModel(std::istream& in);
@@ -141,6 +169,61 @@ class FastText {
       int32_t k,
       real threshold) const;
 
+  bool predictLine(
+      std::istream& in,
+      Predictions& predictions,
+      int32_t k,
+      real threshold) const;
+
+  std::vector<int32_t> getLabelIds(
+      const std::vector<std::string>& labels) const;
+
+  real predict(
+      int32_t k,
+      const std::vector<int32_t>& words,
+      const std::vector<int32_t>& labels,
+      Predictions& predictions,
+      real threshold = 0.0) const;
+
+  bool predictLine(
+      std::istream& in,
+      std::vector<std::pair<real, std::string>>& predictions,
+      const std::vector<int32_t>& labels,
+      real& rest,
+      int32_t k,
+      real threshold) const;
+
+  int64_t addLineToVector(std::istream& in, Vector& sum) const;
+
+  int64_t addLineToVector(
+      std::istream& in,
+      Vector& sum,
+      std::vector<int32_t>& window) const;
+
+  void predict(
+      int32_t k,
+      const Vector& sum,
+      int64_t count,
+      Predictions& predictions,
+      real threshold = 0.0) const;
+
+  bool predictLineStreamed(
+      std::istream& in,
+      std::vector<std::pair<real, std::string>>& predictions,
+      int32_t k,
+      real threshold) const;
+
+  bool predictLineStreamed(
+      std::istream& in,
+      Predictions& predictions,
+      int32_t k,
+      real threshold) const;
+
+  bool predictDistribution(const Vector& sum, int64_t count, Vector& probabilities)
+      const;
+
+  bool predictLineDistribution(std::istream& in, Vector& probabilities) const;
+
   std::vector<std::pair<std::string, Vector>> getNgramVectors(
       const std::string& word) const;
 
@@ -162,6 +245,16 @@ class FastText {
 
   bool isQuant() const;
 
+  matrix_type getInputMatrixType() const;
+
+  void convertToHalf();
+
+  void countRows(std::istream& in, std::vector<int64_t>& counts) const;
+
+  double reorderRows(std::istream& in);
+
+  void pruneRows(const std::vector<int64_t>& counts, int64_t minCount);
+
   class AbortError : public std::runtime_error {
    public:
     AbortError() : std::runtime_error("Aborted.") {}
@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "halfmatrix.h"
+
+#include <assert.h>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__F16C__) && defined(__AVX__)
+#include <immintrin.h>
+#define FASTTEXT_F16C
+#endif
+
+#include "vector.h"
+
+namespace fasttext {
+
+namespace {
+
+#ifdef FASTTEXT_F16C
+
+inline uint16_t toHalf(float x) {
+  return _cvtss_sh(x, _MM_FROUND_TO_NEAREST_INT);
+}
+
+inline float toFloat(uint16_t h) {
+  return _cvtsh_ss(h);
+}
+
+inline __m256 load8(const uint16_t* h) {
+  return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)h));
+}
+
+inline __m256 madd8(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+inline float sum8(__m256 x) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+#else
+
+inline uint32_t toBits(float x) {
+  uint32_t w;
+  std::memcpy(&w, &x, sizeof(w));
+  return w;
+}
+
+inline float fromBits(uint32_t w) {
+  float x;
+  std::memcpy(&x, &w, sizeof(x));
+  return x;
+}
+
+// Portable round-to-nearest-even conversions, matching F16C results.
+uint16_t toHalf(float x) {
+  const uint32_t w = toBits(x);
+  const uint32_t sign = w & 0x80000000u;
+  const uint32_t twice = w + w;
+  if (twice > 0xff000000u) {
+    return (sign >> 16) | 0x7e00u; // NaN
+  }
+  // scale by 2^112 then 2^-110 to saturate large values to infinity
+  float base = (std::fabs(x) * fromBits(0x77800000u)) * fromBits(0x08800000u);
+  uint32_t bias = twice & 0xff000000u;
+  if (bias < 0x71000000u) {
+    bias = 0x71000000u;
+  }
+  // adding 2^(exponent + 13) rounds the mantissa to 10 bits
+  base = fromBits((bias >> 1) + 0x07800000u) + base;
+  const uint32_t bits = toBits(base);
+  return (sign >> 16) | (((bits >> 13) & 0x7c00u) + (bits & 0x0fffu));
+}
+
+float toFloat(uint16_t h) {
+  const uint32_t w = uint32_t(h) << 16;
+  const uint32_t sign = w & 0x80000000u;
+  const uint32_t twice = w + w;
+  if (twice < (1u << 27)) {
+    // subnormal: place the mantissa in a float with exponent -1, remove 0.5
+    return fromBits(sign | toBits(fromBits((twice >> 17) | (126u << 23)) - 0.5f));
+  }
+  // rebias the exponent by 224 and scale by 2^-112, also maps inf and NaN
+  return fromBits(
+      sign | toBits(fromBits((twice >> 4) + (0xe0u << 23)) * fromBits(0x07800000u)));
+}
+
+#endif
+
+} // namespace
+
+HalfMatrix::HalfMatrix() : Matrix() {}
+
+HalfMatrix::HalfMatrix(const DenseMatrix& mat)
+    : Matrix(mat.size(0), mat.size(1)), data_(m_ * n_) {
+  for (int64_t i = 0; i < m_; i++) {
+    for (int64_t j = 0; j < n_; j++) {
+      data_[i * n_ + j] = toHalf(mat.at(i, j));
+    }
+  }
+}
+
+real HalfMatrix::at(int64_t i, int64_t j) const {
+  return toFloat(data_[i * n_ + j]);
+}
+
+real HalfMatrix::dotRow(const Vector& vec, int64_t i) const {
+  assert(i >= 0);
+  assert(i < m_);
+  assert(vec.size() == n_);
+  const uint16_t* row = data_.data() + i * n_;
+  int64_t j = 0;
+  real d = 0.0;
+#ifdef FASTTEXT_F16C
+  __m256 acc = _mm256_setzero_ps();
+  for (; j + 8 <= n_; j += 8) {
+    acc = madd8(load8(row + j), _mm256_loadu_ps(vec.data() + j), acc);
+  }
+  d = sum8(acc);
+#endif
+  for (; j < n_; j++) {
+    d += toFloat(row[j]) * vec[j];
+  }
+  return d;
+}
+
+void HalfMatrix::addVectorToRow(const Vector&, int64_t, real) {
+  throw std::runtime_error(
+      "Operation not permitted on half precision matrices.");
+}
+
+void HalfMatrix::addRowToVector(Vector& x, int32_t i) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  const uint16_t* row = data_.data() + i * n_;
+  int64_t j = 0;
+#ifdef FASTTEXT_F16C
+  for (; j + 8 <= n_; j += 8) {
+    _mm256_storeu_ps(
+        x.data() + j, _mm256_add_ps(load8(row + j), _mm256_loadu_ps(x.data() + j)));
+  }
+#endif
+  for (; j < n_; j++) {
+    x[j] += toFloat(row[j]);
+  }
+}
+
+void HalfMatrix::addRowToVector(Vector& x, int32_t i, real a) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  const uint16_t* row = data_.data() + i * n_;
+  int64_t j = 0;
+#ifdef FASTTEXT_F16C
+  const __m256 va = _mm256_set1_ps(a);
+  for (; j + 8 <= n_; j += 8) {
+    _mm256_storeu_ps(
+        x.data() + j, madd8(va, load8(row + j), _mm256_loadu_ps(x.data() + j)));
+  }
+#endif
+  for (; j < n_; j++) {
+    x[j] += a * toFloat(row[j]);
+  }
+}
+
+void HalfMatrix::permuteRows(const std::vector<int32_t>& order) {
+  permuteBuffer(data_, n_, order);
+}
+
+void HalfMatrix::save(std::ostream& out) const {
+  out.write((char*)&m_, sizeof(int64_t));
+  out.write((char*)&n_, sizeof(int64_t));
+  out.write((char*)data_.data(), m_ * n_ * sizeof(uint16_t));
+}
+
+void HalfMatrix::load(std::istream& in) {
+  in.read((char*)&m_, sizeof(int64_t));
+  in.read((char*)&n_, sizeof(int64_t));
+  data_ = std::vector<uint16_t>(m_ * n_);
+  in.read((char*)data_.data(), m_ * n_ * sizeof(uint16_t));
+}
+
+void HalfMatrix::dump(std::ostream& out) const {
+  out << m_ << " " << n_ << std::endl;
+  for (int64_t i = 0; i < m_; i++) {
+    for (int64_t j = 0; j < n_; j++) {
+      if (j > 0) {
+        out << " ";
+      }
+      out << at(i, j);
+    }
+    out << std::endl;
+  }
+}
+
+} // namespace fasttext
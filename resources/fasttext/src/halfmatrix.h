@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "densematrix.h"
+#include "matrix.h"
+#include "real.h"
+
+namespace fasttext {
+
+class Vector;
+
+// Read-only matrix stored in IEEE half precision. Rows are widened to float
+// when used, so products are still accumulated in single precision.
+class HalfMatrix : public Matrix {
+ protected:
+  std::vector<uint16_t> data_;
+
+ public:
+  HalfMatrix();
+  explicit HalfMatrix(const DenseMatrix&);
+  HalfMatrix(const HalfMatrix&) = delete;
+  HalfMatrix(HalfMatrix&&) = delete;
+  HalfMatrix& operator=(const HalfMatrix&) = delete;
+  HalfMatrix& operator=(HalfMatrix&&) = delete;
+  virtual ~HalfMatrix() noexcept override = default;
+
+  real at(int64_t i, int64_t j) const;
+
+  real dotRow(const Vector&, int64_t) const override;
+  void addVectorToRow(const Vector&, int64_t, real) override;
+  void addRowToVector(Vector& x, int32_t i) const override;
+  void addRowToVector(Vector& x, int32_t i, real a) const override;
+  void permuteRows(const std::vector<int32_t>& order) override;
+  void save(std::ostream&) const override;
+  void load(std::istream&) override;
+  void dump(std::ostream&) const override;
+};
+
+} // namespace fasttext
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "int8matrix.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "vector.h"
+
+namespace fasttext {
+
+namespace {
+
+#ifdef __AVX2__
+
+inline __m256 load8(const uint8_t* codes) {
+  return _mm256_cvtepi32_ps(
+      _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)codes)));
+}
+
+inline __m256 madd8(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+inline float sum8(__m256 x) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+#endif
+
+// x += a * codes + b
+void addCodes(real* x, const uint8_t* codes, int64_t n, real a, real b) {
+  int64_t j = 0;
+#ifdef __AVX2__
+  const __m256 va = _mm256_set1_ps(a);
+  const __m256 vb = _mm256_set1_ps(b);
+  for (; j + 8 <= n; j += 8) {
+    __m256 vx = _mm256_add_ps(_mm256_loadu_ps(x + j), vb);
+    _mm256_storeu_ps(x + j, madd8(va, load8(codes + j), vx));
+  }
+#endif
+  for (; j < n; j++) {
+    x[j] += a * codes[j] + b;
+  }
+}
+
+} // namespace
+
+Int8Matrix::Int8Matrix() : Matrix() {}
+
+Int8Matrix::Int8Matrix(const DenseMatrix& mat)
+    : Matrix(mat.size(0), mat.size(1)),
+      codes_(m_ * n_),
+      scales_(m_),
+      offsets_(m_) {
+  for (int64_t i = 0; i < m_; i++) {
+    const real* row = &mat.at(i, 0);
+    const auto minmax = std::minmax_element(row, row + n_);
+    const real lo = n_ > 0 ? *minmax.first : 0.0;
+    const real hi = n_ > 0 ? *minmax.second : 0.0;
+    offsets_[i] = lo;
+    scales_[i] = (hi - lo) / 255;
+    const real inv = scales_[i] > 0 ? 1 / scales_[i] : 0.0;
+    for (int64_t j = 0; j < n_; j++) {
+      codes_[i * n_ + j] =
+          uint8_t(std::min<real>(255, std::round((row[j] - lo) * inv)));
+    }
+  }
+}
+
+real Int8Matrix::at(int64_t i, int64_t j) const {
+  return offsets_[i] + scales_[i] * codes_[i * n_ + j];
+}
+
+real Int8Matrix::dotRow(const Vector& vec, int64_t i) const {
+  assert(i >= 0);
+  assert(i < m_);
+  assert(vec.size() == n_);
+  // sum_j (offset + scale * c_j) * v_j = scale * sum_j c_j v_j + offset * sum_j v_j
+  const uint8_t* codes = codes_.data() + i * n_;
+  int64_t j = 0;
+  real dot = 0.0;
+  real sum = 0.0;
+#ifdef __AVX2__
+  __m256 vdot = _mm256_setzero_ps();
+  __m256 vsum = _mm256_setzero_ps();
+  for (; j + 8 <= n_; j += 8) {
+    const __m256 v = _mm256_loadu_ps(vec.data() + j);
+    vdot = madd8(load8(codes + j), v, vdot);
+    vsum = _mm256_add_ps(vsum, v);
+  }
+  dot = sum8(vdot);
+  sum = sum8(vsum);
+#endif
+  for (; j < n_; j++) {
+    dot += codes[j] * vec[j];
+    sum += vec[j];
+  }
+  return scales_[i] * dot + offsets_[i] * sum;
+}
+
+void Int8Matrix::addVectorToRow(const Vector&, int64_t, real) {
+  throw std::runtime_error("Operation not permitted on quantized matrices.");
+}
+
+void Int8Matrix::addRowToVector(Vector& x, int32_t i) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  addCodes(x.data(), codes_.data() + i * n_, n_, scales_[i], offsets_[i]);
+}
+
+void Int8Matrix::addRowToVector(Vector& x, int32_t i, real a) const {
+  assert(i >= 0);
+  assert(i < this->size(0));
+  assert(x.size() == this->size(1));
+  addCodes(
+      x.data(), codes_.data() + i * n_, n_, a * scales_[i], a * offsets_[i]);
+}
+
+void Int8Matrix::permuteRows(const std::vector<int32_t>& order) {
+  permuteBuffer(codes_, n_, order);
+  permuteBuffer(scales_, 1, order);
+  permuteBuffer(offsets_, 1, order);
+}
+
+void Int8Matrix::save(std::ostream& out) const {
+  out.write((char*)&m_, sizeof(int64_t));
+  out.write((char*)&n_, sizeof(int64_t));
+  out.write((char*)scales_.data(), m_ * sizeof(real));
+  out.write((char*)offsets_.data(), m_ * sizeof(real));
+  out.write((char*)codes_.data(), m_ * n_ * sizeof(uint8_t));
+}
+
+void Int8Matrix::load(std::istream& in) {
+  in.read((char*)&m_, sizeof(int64_t));
+  in.read((char*)&n_, sizeof(int64_t));
+  scales_ = std::vector<real>(m_);
+  offsets_ = std::vector<real>(m_);
+  codes_ = std::vector<uint8_t>(m_ * n_);
+  in.read((char*)scales_.data(), m_ * sizeof(real));
+  in.read((char*)offsets_.data(), m_ * sizeof(real));
+  in.read((char*)codes_.data(), m_ * n_ * sizeof(uint8_t));
+}
+
+void Int8Matrix::dump(std::ostream&) const {
+  throw std::runtime_error("Operation not permitted on quantized matrices.");
+}
+
+} // namespace fasttext
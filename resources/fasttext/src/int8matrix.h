@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "densematrix.h"
+#include "matrix.h"
+#include "real.h"
+
+namespace fasttext {
+
+class Vector;
+
+// Read-only matrix quantized row by row to 8 bits: an element is decoded as
+// offset + scale * code, where offset is the minimum of the row (a zero point
+// kept as a float) and scale spreads the row range over 256 levels.
+class Int8Matrix : public Matrix {
+ protected:
+  std::vector<uint8_t> codes_;
+  std::vector<real> scales_;
+  std::vector<real> offsets_;
+
+ public:
+  Int8Matrix();
+  explicit Int8Matrix(const DenseMatrix&);
+  Int8Matrix(const Int8Matrix&) = delete;
+  Int8Matrix(Int8Matrix&&) = delete;
+  Int8Matrix& operator=(const Int8Matrix&) = delete;
+  Int8Matrix& operator=(Int8Matrix&&) = delete;
+  virtual ~Int8Matrix() noexcept override = default;
+
+  real at(int64_t i, int64_t j) const;
+
+  real dotRow(const Vector&, int64_t) const override;
+  void addVectorToRow(const Vector&, int64_t, real) override;
+  void addRowToVector(Vector& x, int32_t i) const override;
+  void addRowToVector(Vector& x, int32_t i, real a) const override;
+  void permuteRows(const std::vector<int32_t>& order) override;
+  void save(std::ostream&) const override;
+  void load(std::istream&) override;
+  void dump(std::ostream&) const override;
+};
+
+} // namespace fasttext
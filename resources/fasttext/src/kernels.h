@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "real.h"
+
+namespace fasttext {
+namespace kernels {
+
+// Requests the cache lines of a row of n floats.
+inline void prefetchRow(const real* row, int64_t n) {
+#if defined(__GNUC__)
+  for (int64_t j = 0; j < n; j += 64 / sizeof(real)) {
+    __builtin_prefetch(row + j);
+  }
+  // rows are not necessarily aligned to cache lines
+  __builtin_prefetch(row + n - 1);
+#endif
+}
+
+// Inner loops over the rows of a row-major matrix with N columns, rows being
+// `stride` floats apart. With N known at compile time the loops are fully
+// unrolled and the accumulated vector stays in registers; N == 0 handles any
+// width given at run time. Every sum is accumulated in the same order as the
+// plain loops would.
+template <int64_t N>
+struct Rows {
+  // x += sum of the rows ids[0..count), prefetching the row `distance` ids
+  // ahead
+  static void add(
+      real* x,
+      const real* data,
+      int64_t,
+      int64_t stride,
+      const int32_t* ids,
+      int64_t count,
+      int64_t distance) {
+    real acc[N];
+    for (int64_t j = 0; j < N; j++) {
+      acc[j] = x[j];
+    }
+    for (int64_t k = 0; k < count; k++) {
+      if (distance > 0 && k + distance < count) {
+        prefetchRow(data + int64_t(ids[k + distance]) * stride, N);
+      }
+      const real* row = data + int64_t(ids[k]) * stride;
+      for (int64_t j = 0; j < N; j++) {
+        acc[j] += row[j];
+      }
+    }
+    for (int64_t j = 0; j < N; j++) {
+      x[j] = acc[j];
+    }
+  }
+
+  static real dot(const real* row, const real* x, int64_t) {
+    real d = 0.0;
+    for (int64_t j = 0; j < N; j++) {
+      d += row[j] * x[j];
+    }
+    return d;
+  }
+
+  // out[i] = dot(row i, x) for the m rows, four independent sums at a time
+  static void dots(
+      const real* data,
+      int64_t m,
+      int64_t,
+      int64_t stride,
+      const real* x,
+      real* out) {
+    real v[N];
+    for (int64_t j = 0; j < N; j++) {
+      v[j] = x[j];
+    }
+    int64_t i = 0;
+    for (; i + 4 <= m; i += 4) {
+      const real* r0 = data + i * stride;
+      const real* r1 = r0 + stride;
+      const real* r2 = r1 + stride;
+      const real* r3 = r2 + stride;
+      real d0 = 0.0, d1 = 0.0, d2 = 0.0, d3 = 0.0;
+      for (int64_t j = 0; j < N; j++) {
+        d0 += r0[j] * v[j];
+        d1 += r1[j] * v[j];
+        d2 += r2[j] * v[j];
+        d3 += r3[j] * v[j];
+      }
+      out[i] = d0;
+      out[i + 1] = d1;
+      out[i + 2] = d2;
+      out[i + 3] = d3;
+    }
+    for (; i < m; i++) {
+      out[i] = dot(data + i * stride, v, N);
+    }
+  }
+};
+
+template <>
+struct Rows<0> {
+  static void add(
+      real* x,
+      const real* data,
+      int64_t n,
+      int64_t stride,
+      const int32_t* ids,
+      int64_t count,
+      int64_t distance) {
+    for (int64_t k = 0; k < count; k++) {
+      if (distance > 0 && k + distance < count) {
+        prefetchRow(data + int64_t(ids[k + distance]) * stride, n);
+      }
+      const real* row = data + int64_t(ids[k]) * stride;
+      for (int64_t j = 0; j < n; j++) {
+        x[j] += row[j];
+      }
+    }
+  }
+
+  static real dot(const real* row, const real* x, int64_t n) {
+    real d = 0.0;
+    for (int64_t j = 0; j < n; j++) {
+      d += row[j] * x[j];
+    }
+    return d;
+  }
+
+  static void dots(
+      const real* data,
+      int64_t m,
+      int64_t n,
+      int64_t stride,
+      const real* x,
+      real* out) {
+    for (int64_t i = 0; i < m; i++) {
+      out[i] = dot(data + i * stride, x, n);
+    }
+  }
+};
+
+struct Kernels {
+  void (*add)(
+      real*,
+      const real*,
+      int64_t,
+      int64_t,
+      const int32_t*,
+      int64_t,
+      int64_t);
+  real (*dot)(const real*, const real*, int64_t);
+  void (*dots)(const real*, int64_t, int64_t, int64_t, const real*, real*);
+};
+
+template <int64_t N>
+const Kernels* table() {
+  static const Kernels kernels = {&Rows<N>::add, &Rows<N>::dot, &Rows<N>::dots};
+  return &kernels;
+}
+
+// Kernels specialized for the width n if it is a common dimension, the
+// generic ones otherwise.
+inline const Kernels* select(int64_t n) {
+  switch (n) {
+    case 16:
+      return table<16>();
+    case 32:
+      return table<32>();
+    case 50:
+      return table<50>();
+    case 64:
+      return table<64>();
+    case 100:
+      return table<100>();
+    case 128:
+      return table<128>();
+    case 300:
+      return table<300>();
+    default:
+      return table<0>();
+  }
+}
+
+} // namespace kernels
+} // namespace fasttext
@@ -92,6 +92,29 @@ void Loss::findKBest(
   }
 }
 
+// output[i] is the probability of labels[i].
+void Loss::findKBest(
+    int32_t k,
+    real threshold,
+    Predictions& heap,
+    const Vector& output,
+    const std::vector<int32_t>& labels) const {
+  for (int32_t i = 0; i < labels.size(); i++) {
+    if (output[i] < threshold) {
+      continue;
+    }
+    if (heap.size() == k && std_log(output[i]) < heap.front().first) {
+      continue;
+    }
+    heap.push_back(std::make_pair(std_log(output[i]), labels[i]));
+    std::push_heap(heap.begin(), heap.end(), comparePairs);
+    if (heap.size() > k) {
+      std::pop_heap(heap.begin(), heap.end(), comparePairs);
+      heap.pop_back();
+    }
+  }
+}
+
 BinaryLogisticLoss::BinaryLogisticLoss(std::shared_ptr<Matrix>& wo)
     : Loss(wo) {}
 
@@ -123,6 +146,23 @@ void BinaryLogisticLoss::computeOutput(Model::State& state) const {
   }
 }
 
+// Labels are scored independently, so the scores are exact and the other
+// labels do not add up to a probability.
+real BinaryLogisticLoss::predictLabels(
+    int32_t k,
+    real threshold,
+    const std::vector<int32_t>& labels,
+    Predictions& heap,
+    Model::State& state) const {
+  Vector& output = state.output;
+  for (int32_t i = 0; i < labels.size(); i++) {
+    output[i] = sigmoid(wo_->dotRow(state.hidden, labels[i]));
+  }
+  findKBest(k, threshold, heap, output, labels);
+  std::sort_heap(heap.begin(), heap.end(), comparePairs);
+  return -1.0;
+}
+
 OneVsAllLoss::OneVsAllLoss(std::shared_ptr<Matrix>& wo)
     : BinaryLogisticLoss(wo) {}
 
@@ -260,6 +300,25 @@ real HierarchicalSoftmaxLoss::forward(
   return loss;
 }
 
+// Probabilities of all leaves, from the root down: internal nodes are
+// created after their children, so they have larger ids.
+void HierarchicalSoftmaxLoss::computeOutput(Model::State& state) const {
+  // every node is written below, so the buffer of the thread is reused as is
+  static thread_local std::vector<real> probabilities;
+  probabilities.resize(2 * osz_ - 1);
+  probabilities[2 * osz_ - 2] = 1.0;
+  for (int32_t node = 2 * osz_ - 2; node >= osz_; node--) {
+    real f = wo_->dotRow(state.hidden, node - osz_);
+    f = 1. / (1 + std::exp(-f));
+    probabilities[tree_[node].left] = probabilities[node] * (1.0 - f);
+    probabilities[tree_[node].right] = probabilities[node] * f;
+  }
+  Vector& output = state.output;
+  for (int32_t i = 0; i < osz_; i++) {
+    output[i] = probabilities[i];
+  }
+}
+
 void HierarchicalSoftmaxLoss::predict(
     int32_t k,
     real threshold,
@@ -269,6 +328,51 @@ void HierarchicalSoftmaxLoss::predict(
   std::sort_heap(heap.begin(), heap.end(), comparePairs);
 }
 
+// Only the nodes on the paths of `labels` are scored, each once. The scores
+// are the exact probabilities of the tree, so the other labels get the rest.
+real HierarchicalSoftmaxLoss::predictLabels(
+    int32_t k,
+    real threshold,
+    const std::vector<int32_t>& labels,
+    Predictions& heap,
+    Model::State& state) const {
+  // log-probabilities of the left and right children of each node
+  std::vector<real> branches(2 * (osz_ - 1));
+  std::vector<bool> scored(osz_ - 1, false);
+  real sum = 0.0;
+  for (const auto label : labels) {
+    const std::vector<int32_t>& path = paths_[label];
+    const std::vector<bool>& code = codes_[label];
+    real score = 0.0;
+    for (int32_t i = path.size() - 1; i >= 0; i--) {
+      int32_t node = path[i];
+      if (!scored[node]) {
+        real f = wo_->dotRow(state.hidden, node);
+        f = 1. / (1 + std::exp(-f));
+        branches[2 * node] = std_log(1.0 - f);
+        branches[2 * node + 1] = std_log(f);
+        scored[node] = true;
+      }
+      score += branches[2 * node + code[i]];
+    }
+    sum += std::exp(score);
+    if (score < std_log(threshold)) {
+      continue;
+    }
+    if (heap.size() == k && score < heap.front().first) {
+      continue;
+    }
+    heap.push_back(std::make_pair(score, label));
+    std::push_heap(heap.begin(), heap.end(), comparePairs);
+    if (heap.size() > k) {
+      std::pop_heap(heap.begin(), heap.end(), comparePairs);
+      heap.pop_back();
+    }
+  }
+  std::sort_heap(heap.begin(), heap.end(), comparePairs);
+  return std::max(real(1.0) - sum, real(0.0));
+}
+
 void HierarchicalSoftmaxLoss::dfs(
     int32_t k,
     real threshold,
@@ -319,6 +423,38 @@ void SoftmaxLoss::computeOutput(Model::State& state) const {
   }
 }
 
+// The softmax is normalized over `labels`, which gives the probabilities
+// given that the label is one of them; the others are not scored.
+real SoftmaxLoss::predictLabels(
+    int32_t k,
+    real threshold,
+    const std::vector<int32_t>& labels,
+    Predictions& heap,
+    Model::State& state) const {
+  if (labels.empty()) {
+    return -1.0;
+  }
+  Vector& output = state.output;
+  int32_t osz = labels.size();
+  for (int32_t i = 0; i < osz; i++) {
+    output[i] = wo_->dotRow(state.hidden, labels[i]);
+  }
+  real max = output[0], z = 0.0;
+  for (int32_t i = 0; i < osz; i++) {
+    max = std::max(output[i], max);
+  }
+  for (int32_t i = 0; i < osz; i++) {
+    output[i] = exp(output[i] - max);
+    z += output[i];
+  }
+  for (int32_t i = 0; i < osz; i++) {
+    output[i] /= z;
+  }
+  findKBest(k, threshold, heap, output, labels);
+  std::sort_heap(heap.begin(), heap.end(), comparePairs);
+  return -1.0;
+}
+
 real SoftmaxLoss::forward(
     const std::vector<int32_t>& targets,
     int32_t targetIndex,
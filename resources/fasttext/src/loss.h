@@ -29,6 +29,13 @@ class Loss {
       const Vector& output) const;
 
  protected:
+  void findKBest(
+      int32_t k,
+      real threshold,
+      Predictions& heap,
+      const Vector& output,
+      const std::vector<int32_t>& labels) const;
+
   std::vector<real> t_sigmoid_;
   std::vector<real> t_log_;
   std::shared_ptr<Matrix>& wo_;
@@ -53,6 +60,14 @@ class Loss {
       real /*threshold*/,
       Predictions& /*heap*/,
       Model::State& /*state*/) const;
+  // Scores `labels` only. Returns the probability of all other labels
+  // together, or -1 when the loss cannot tell it without scoring them.
+  virtual real predictLabels(
+      int32_t k,
+      real threshold,
+      const std::vector<int32_t>& labels,
+      Predictions& heap,
+      Model::State& state) const = 0;
 };
 
 class BinaryLogisticLoss : public Loss {
@@ -68,6 +83,12 @@ class BinaryLogisticLoss : public Loss {
   explicit BinaryLogisticLoss(std::shared_ptr<Matrix>& wo);
   virtual ~BinaryLogisticLoss() noexcept override = default;
   void computeOutput(Model::State& state) const override;
+  real predictLabels(
+      int32_t k,
+      real threshold,
+      const std::vector<int32_t>& labels,
+      Predictions& heap,
+      Model::State& state) const override;
 };
 
 class OneVsAllLoss : public BinaryLogisticLoss {
@@ -140,11 +161,18 @@ class HierarchicalSoftmaxLoss : public BinaryLogisticLoss {
       Model::State& state,
       real lr,
       bool backprop) override;
+  void computeOutput(Model::State& state) const override;
   void predict(
       int32_t k,
       real threshold,
       Predictions& heap,
       Model::State& state) const override;
+  real predictLabels(
+      int32_t k,
+      real threshold,
+      const std::vector<int32_t>& labels,
+      Predictions& heap,
+      Model::State& state) const override;
 };
 
 class SoftmaxLoss : public Loss {
@@ -158,6 +186,12 @@ class SoftmaxLoss : public Loss {
       real lr,
       bool backprop) override;
   void computeOutput(Model::State& state) const override;
+  real predictLabels(
+      int32_t k,
+      real threshold,
+      const std::vector<int32_t>& labels,
+      Predictions& heap,
+      Model::State& state) const override;
 };
 
 } // namespace fasttext
@@ -40,6 +40,11 @@ void printUsage() {
       << "  analogies               query for analogies\n"
       << "  dump                    dump arguments,dictionary,input/output "
          "vectors\n"
+      << "  precompute              store subword tables to speed up model "
+         "loading\n"
+      << "  half                    store input vectors in half precision\n"
+      << "  reorder                 store the input vectors used by a corpus "
+         "first\n"
       << std::endl;
 }
 
@@ -132,6 +137,20 @@ void printDumpUsage() {
             << "  <option>     option from args,dict,input,output" << std::endl;
 }
 
+void printPrecomputeUsage() {
+  std::cerr << "usage: fasttext precompute <model> <output>\n\n"
+            << "  <model>      model filename\n"
+            << "  <output>     output model filename\n"
+            << std::endl;
+}
+
+void printHalfUsage() {
+  std::cerr << "usage: fasttext half <model> <output>\n\n"
+            << "  <model>      model filename\n"
+            << "  <output>     output model filename\n"
+            << std::endl;
+}
+
 void test(const std::vector<std::string>& args) {
   bool perLabel = args[1] == "test-label";
 
@@ -404,6 +423,8 @@ void dump(const std::vector<std::string>& args) {
   } else if (option == "input") {
     if (fasttext.isQuant()) {
       std::cerr << "Not supported for quantized models." << std::endl;
+    } else if (fasttext.getInputMatrixType() == matrix_type::half) {
+      std::cerr << "Not supported for half precision models." << std::endl;
     } else {
       fasttext.getInputMatrix()->dump(std::cout);
     }
@@ -419,6 +440,63 @@ void dump(const std::vector<std::string>& args) {
   }
 }
 
+void precompute(const std::vector<std::string>& args) {
+  if (args.size() != 4) {
+    printPrecomputeUsage();
+    exit(EXIT_FAILURE);
+  }
+  FastText fasttext;
+  fasttext.loadModel(args[2]);
+  fasttext.setPrecomputed(true);
+  fasttext.saveModel(args[3]);
+  exit(0);
+}
+
+void printReorderUsage() {
+  std::cerr << "usage: fasttext reorder <model> <corpus> <output>\n\n"
+            << "  <model>      model filename\n"
+            << "  <corpus>     representative text, one document per line\n"
+            << "  <output>     output model filename\n\n"
+            << "The ngram buckets are reordered only in pruned models.\n"
+            << std::endl;
+}
+
+void half(const std::vector<std::string>& args) {
+  if (args.size() != 4) {
+    printHalfUsage();
+    exit(EXIT_FAILURE);
+  }
+  FastText fasttext;
+  fasttext.loadModel(args[2]);
+  fasttext.convertToHalf();
+  fasttext.saveModel(args[3]);
+  exit(0);
+}
+
+void reorder(const std::vector<std::string>& args) {
+  if (args.size() != 5) {
+    printReorderUsage();
+    exit(EXIT_FAILURE);
+  }
+  FastText fasttext;
+  fasttext.loadModel(args[2]);
+  std::ifstream ifs(args[3]);
+  if (!ifs.is_open()) {
+    std::cerr << "Corpus file cannot be opened!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const double moved = fasttext.reorderRows(ifs);
+  if (!fasttext.getDictionary()->isPruned()) {
+    std::cerr << "Warning: the model is not pruned, only the rows of words "
+              << "are reordered and the ngram buckets keep their place."
+              << std::endl;
+  }
+  std::cerr << "Reordered rows serve " << std::fixed << std::setprecision(1)
+            << 100.0 * moved << "% of the row uses of the corpus." << std::endl;
+  fasttext.saveModel(args[4]);
+  exit(0);
+}
+
 int main(int argc, char** argv) {
   std::vector<std::string> args(argv, argv + argc);
   if (args.size() < 2) {
@@ -446,6 +524,12 @@ int main(int argc, char** argv) {
     predict(args);
   } else if (command == "dump") {
     dump(args);
+  } else if (command == "precompute") {
+    precompute(args);
+  } else if (command == "half") {
+    half(args);
+  } else if (command == "reorder") {
+    reorder(args);
   } else {
     printUsage();
     exit(EXIT_FAILURE);
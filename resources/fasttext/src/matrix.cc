@@ -8,11 +8,13 @@
 
 #include "matrix.h"
 
+#include "vector.h"
+
 namespace fasttext {
 
-Matrix::Matrix() : m_(0), n_(0) {}
+Matrix::Matrix() : Matrix(0, 0) {}
 
-Matrix::Matrix(int64_t m, int64_t n) : m_(m), n_(n) {}
+Matrix::Matrix(int64_t m, int64_t n) : m_(m), n_(n), prefetchDistance_(0) {}
 
 int64_t Matrix::size(int64_t dim) const {
   assert(dim == 0 || dim == 1);
@@ -22,4 +24,27 @@ int64_t Matrix::size(int64_t dim) const {
   return n_;
 }
 
+void Matrix::setPrefetchDistance(int32_t distance) {
+  assert(distance >= 0);
+  prefetchDistance_ = distance;
+}
+
+int32_t Matrix::getPrefetchDistance() const {
+  return prefetchDistance_;
+}
+
+void Matrix::addRowsToVector(Vector& x, const int32_t* ids, int64_t count)
+    const {
+  for (int64_t k = 0; k < count; k++) {
+    addRowToVector(x, ids[k]);
+  }
+}
+
+void Matrix::dotRows(const Vector& vec, Vector& out) const {
+  assert(out.size() == m_);
+  for (int64_t i = 0; i < m_; i++) {
+    out[i] = dotRow(vec, i);
+  }
+}
+
 } // namespace fasttext
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <istream>
 #include <ostream>
@@ -20,10 +21,33 @@ namespace fasttext {
 
 class Vector;
 
+// Storage of the input matrix, as tagged in model files.
+enum class matrix_type : uint8_t { dense = 0, quant = 1, half = 2, int8 = 3 };
+
 class Matrix {
  protected:
   int64_t m_;
   int64_t n_;
+  int32_t prefetchDistance_;
+
+  // Moves row order[i] of a row-major buffer with rows of `width` elements
+  // to row i.
+  template <typename T, typename A>
+  void permuteBuffer(
+      std::vector<T, A>& data,
+      int64_t width,
+      const std::vector<int32_t>& order) const {
+    assert(int64_t(order.size()) == m_);
+    assert(int64_t(data.size()) >= m_ * width);
+    std::vector<T, A> permuted(data.size());
+    for (int64_t i = 0; i < m_; i++) {
+      std::copy(
+          data.begin() + order[i] * width,
+          data.begin() + (order[i] + 1) * width,
+          permuted.begin() + i * width);
+    }
+    data.swap(permuted);
+  }
 
  public:
   Matrix();
@@ -32,10 +56,21 @@ class Matrix {
 
   int64_t size(int64_t dim) const;
 
+  // Rows gathered by addRowsToVector are prefetched this many ids ahead.
+  // 0, the default, disables prefetching; benchmarks/embedding_bag.cc
+  // measures the distances on a given model and text.
+  void setPrefetchDistance(int32_t);
+  int32_t getPrefetchDistance() const;
+
   virtual real dotRow(const Vector&, int64_t) const = 0;
   virtual void addVectorToRow(const Vector&, int64_t, real) = 0;
   virtual void addRowToVector(Vector& x, int32_t i) const = 0;
   virtual void addRowToVector(Vector& x, int32_t i, real a) const = 0;
+  virtual void addRowsToVector(Vector& x, const int32_t* ids, int64_t count)
+      const;
+  virtual void dotRows(const Vector&, Vector& out) const;
+  // Row i becomes the former row order[i].
+  virtual void permuteRows(const std::vector<int32_t>& order) = 0;
   virtual void save(std::ostream&) const = 0;
   virtual void load(std::istream&) = 0;
   virtual void dump(std::ostream&) const = 0;
@@ -37,14 +37,54 @@ Model::Model(
     std::shared_ptr<Matrix> wo,
     std::shared_ptr<Loss> loss,
     bool normalizeGradient)
-    : wi_(wi), wo_(wo), loss_(loss), normalizeGradient_(normalizeGradient) {}
+    : wi_(wi),
+      wo_(wo),
+      loss_(loss),
+      normalizeGradient_(normalizeGradient),
+      foldDuplicates_(false) {}
+
+void Model::setFoldDuplicates(bool foldDuplicates) {
+  foldDuplicates_ = foldDuplicates;
+}
 
 void Model::computeHidden(const std::vector<int32_t>& input, State& state)
     const {
   Vector& hidden = state.hidden;
   hidden.zero();
-  for (auto it = input.cbegin(); it != input.cend(); ++it) {
-    hidden.addRow(*wi_, *it);
+  if (foldDuplicates_) {
+    // count ids in an open addressing table of (id, count), add repeated ids
+    // scaled and gather the single ones in their input order
+    std::vector<std::pair<int32_t, int32_t>>& counts = state.counts;
+    std::vector<int32_t>& ids = state.ids;
+    int32_t bits = 4;
+    while ((size_t(1) << bits) < 2 * input.size()) {
+      bits++;
+    }
+    const size_t mask = (size_t(1) << bits) - 1;
+    counts.assign(mask + 1, std::make_pair(-1, 0));
+    ids.clear();
+    for (auto it = input.cbegin(); it != input.cend(); ++it) {
+      size_t h = (uint32_t(*it) * 2654435761u) >> (32 - bits);
+      while (counts[h].first != -1 && counts[h].first != *it) {
+        h = (h + 1) & mask;
+      }
+      if (counts[h].second++ == 0) {
+        counts[h].first = *it;
+        ids.push_back(h);
+      }
+    }
+    size_t singles = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+      const std::pair<int32_t, int32_t>& entry = counts[ids[i]];
+      if (entry.second == 1) {
+        ids[singles++] = entry.first;
+      } else {
+        hidden.addRow(*wi_, entry.first, real(entry.second));
+      }
+    }
+    wi_->addRowsToVector(hidden, ids.data(), singles);
+  } else {
+    wi_->addRowsToVector(hidden, input.data(), input.size());
   }
   hidden.mul(1.0 / input.size());
 }
@@ -66,6 +106,56 @@ void Model::predict(
   loss_->predict(k, threshold, heap, state);
 }
 
+// Predicts for an input of `count` ids whose input rows sum to `sum`.
+void Model::predict(
+    const Vector& sum,
+    int64_t count,
+    int32_t k,
+    real threshold,
+    Predictions& heap,
+    State& state) const {
+  if (k == Model::kUnlimitedPredictions) {
+    k = wo_->size(0); // output size
+  } else if (k <= 0) {
+    throw std::invalid_argument("k needs to be 1 or higher!");
+  }
+  heap.reserve(k + 1);
+  state.hidden = sum;
+  state.hidden.mul(1.0 / count);
+
+  loss_->predict(k, threshold, heap, state);
+}
+
+// Probabilities of all labels in state.output, indexed by label id.
+void Model::predictDistribution(
+    const Vector& sum,
+    int64_t count,
+    State& state) const {
+  state.hidden = sum;
+  state.hidden.mul(1.0 / count);
+  loss_->computeOutput(state);
+}
+
+// Predictions among `labels` only, returns the probability of the others
+// or -1 when the loss does not provide it.
+real Model::predict(
+    const std::vector<int32_t>& input,
+    const std::vector<int32_t>& labels,
+    int32_t k,
+    real threshold,
+    Predictions& heap,
+    State& state) const {
+  if (k == Model::kUnlimitedPredictions) {
+    k = labels.size();
+  } else if (k <= 0) {
+    throw std::invalid_argument("k needs to be 1 or higher!");
+  }
+  heap.reserve(k + 1);
+  computeHidden(input, state);
+
+  return loss_->predictLabels(k, threshold, labels, heap, state);
+}
+
 void Model::update(
     const std::vector<int32_t>& input,
     const std::vector<int32_t>& targets,
@@ -28,6 +28,7 @@ class Model {
   std::shared_ptr<Matrix> wo_;
   std::shared_ptr<Loss> loss_;
   bool normalizeGradient_;
+  bool foldDuplicates_;
 
  public:
   Model(
@@ -50,6 +51,8 @@ class Model {
     Vector output;
     Vector grad;
     std::minstd_rand rng;
+    std::vector<int32_t> ids;
+    std::vector<std::pair<int32_t, int32_t>> counts;
 
     State(int32_t hiddenSize, int32_t outputSize, int32_t seed);
     real getLoss() const;
@@ -62,6 +65,22 @@ class Model {
       real threshold,
       Predictions& heap,
       State& state) const;
+  void predict(
+      const Vector& sum,
+      int64_t count,
+      int32_t k,
+      real threshold,
+      Predictions& heap,
+      State& state) const;
+  void predictDistribution(const Vector& sum, int64_t count, State& state)
+      const;
+  real predict(
+      const std::vector<int32_t>& input,
+      const std::vector<int32_t>& labels,
+      int32_t k,
+      real threshold,
+      Predictions& heap,
+      State& state) const;
   void update(
       const std::vector<int32_t>& input,
       const std::vector<int32_t>& targets,
@@ -70,6 +89,10 @@ class Model {
       State& state);
   void computeHidden(const std::vector<int32_t>& input, State& state) const;
 
+  // Adds the row of an id repeated in the input once, scaled by its count,
+  // instead of once per occurrence. Sums are reassociated.
+  void setFoldDuplicates(bool);
+
   real std_log(real) const;
 
   static const int32_t kUnlimitedPredictions = -1;
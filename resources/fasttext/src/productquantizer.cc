@@ -182,6 +182,17 @@ real ProductQuantizer::mulcode(
   real res = 0.0;
   auto d = dsub_;
   const uint8_t* code = codes + nsubq_ * t;
+  if (dsub_ == 2 && lastdsub_ == 2) {
+    // default sub-vector size: fixed stride, no last sub-quantizer case
+    const real* c0 = centroids_.data();
+    const real* xd = x.data();
+    for (auto m = 0; m < nsubq_; m++) {
+      const real* c = c0 + (m * ksub_ + code[m]) * 2;
+      res += xd[2 * m] * c[0];
+      res += xd[2 * m + 1] * c[1];
+    }
+    return res * alpha;
+  }
   for (auto m = 0; m < nsubq_; m++) {
     const real* c = get_centroids(m, code[m]);
     if (m == nsubq_ - 1) {
@@ -201,6 +212,16 @@ void ProductQuantizer::addcode(
     real alpha) const {
   auto d = dsub_;
   const uint8_t* code = codes + nsubq_ * t;
+  if (dsub_ == 2 && lastdsub_ == 2) {
+    const real* c0 = centroids_.data();
+    real* xd = x.data();
+    for (auto m = 0; m < nsubq_; m++) {
+      const real* c = c0 + (m * ksub_ + code[m]) * 2;
+      xd[2 * m] += alpha * c[0];
+      xd[2 * m + 1] += alpha * c[1];
+    }
+    return;
+  }
   for (auto m = 0; m < nsubq_; m++) {
     const real* c = get_centroids(m, code[m]);
     if (m == nsubq_ - 1) {
@@ -243,9 +264,7 @@ void ProductQuantizer::load(std::istream& in) {
   in.read((char*)&dsub_, sizeof(dsub_));
   in.read((char*)&lastdsub_, sizeof(lastdsub_));
   centroids_.resize(dim_ * ksub_);
-  for (auto i = 0; i < centroids_.size(); i++) {
-    in.read((char*)&centroids_[i], sizeof(real));
-  }
+  in.read((char*)centroids_.data(), centroids_.size() * sizeof(real));
 }
 
 } // namespace fasttext
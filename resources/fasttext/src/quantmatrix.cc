@@ -44,6 +44,7 @@ void QuantMatrix::quantize(DenseMatrix&& mat) {
     mat.divideRow(norms);
     quantizeNorm(norms);
   }
+  mat.padRows(1);
   auto dataptr = mat.data();
   pq_->train(m_, dataptr);
   pq_->compute_codes(dataptr, codes_.data(), m_);
@@ -80,6 +81,13 @@ void QuantMatrix::addRowToVector(Vector& x, int32_t i) const {
   pq_->addcode(x, codes_.data(), i, norm);
 }
 
+void QuantMatrix::permuteRows(const std::vector<int32_t>& order) {
+  permuteBuffer(codes_, codesize_ / m_, order);
+  if (qnorm_) {
+    permuteBuffer(norm_codes_, 1, order);
+  }
+}
+
 void QuantMatrix::save(std::ostream& out) const {
   out.write((char*)&qnorm_, sizeof(qnorm_));
   out.write((char*)&m_, sizeof(m_));
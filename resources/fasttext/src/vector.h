@@ -12,6 +12,7 @@
 #include <ostream>
 #include <vector>
 
+#include "aligned.h"
 #include "real.h"
 
 namespace fasttext {
@@ -20,7 +21,7 @@ class Matrix;
 
 class Vector {
  protected:
-  std::vector<real> data_;
+  std::vector<real, AlignedAllocator<real>> data_;
 
  public:
   explicit Vector(int64_t);
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Checks the streamed prediction against predictLine and the round trips of
+// the precomputed, half precision and int8 model formats on a small model
+// trained from generated text. Takes a directory for its files.
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/fasttext.h"
+
+using namespace fasttext;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+  if (!condition) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+const char* const kTopics[][6] = {
+    {"goal", "match", "team", "league", "coach", "score"},
+    {"recipe", "oven", "flour", "sugar", "bake", "dinner"},
+    {"market", "stock", "price", "bank", "invest", "profit"},
+};
+
+std::string makeLine(std::minstd_rand& rng, int topic) {
+  std::uniform_int_distribution<int> word(0, 5);
+  std::ostringstream line;
+  for (int i = 0; i < 8; i++) {
+    line << (i ? " " : "") << kTopics[topic][word(rng)];
+    if (i % 3 == 2) {
+      line << " " << kTopics[(topic + 1) % 3][word(rng)];
+    }
+  }
+  return line.str();
+}
+
+std::vector<std::string> makeLines(std::minstd_rand& rng, int n) {
+  std::vector<std::string> lines;
+  for (int i = 0; i < n; i++) {
+    lines.push_back(makeLine(rng, i % 3));
+  }
+  // a line without known words and one with repeated words
+  lines.push_back("unseen tokens only");
+  lines.push_back("goal goal goal goal team team");
+  return lines;
+}
+
+void train(FastText& fasttext, const std::string& dir) {
+  std::minstd_rand rng(1);
+  const std::string input = dir + "/train.txt";
+  std::ofstream ofs(input);
+  for (int i = 0; i < 600; i++) {
+    ofs << "__label__" << i % 3 << " " << makeLine(rng, i % 3) << "\n";
+  }
+  ofs.close();
+
+  Args args;
+  args.input = input;
+  args.model = model_name::sup;
+  args.loss = loss_name::softmax;
+  args.dim = 16;
+  args.epoch = 5;
+  args.minCount = 1;
+  args.minn = 2;
+  args.maxn = 3;
+  args.wordNgrams = 2;
+  args.bucket = 10000;
+  args.thread = 1;
+  args.verbose = 0;
+  fasttext.train(args);
+}
+
+std::vector<Predictions> predictAll(
+    const FastText& fasttext,
+    const std::vector<std::string>& lines,
+    bool streamed) {
+  std::vector<Predictions> all;
+  for (const auto& line : lines) {
+    std::istringstream in(line);
+    Predictions predictions;
+    if (streamed) {
+      fasttext.predictLineStreamed(in, predictions, -1, 0.0);
+    } else {
+      fasttext.predictLine(in, predictions, -1, 0.0);
+    }
+    all.push_back(predictions);
+  }
+  return all;
+}
+
+bool same(
+    const std::vector<Predictions>& a,
+    const std::vector<Predictions>& b,
+    real tolerance) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].size() != b[i].size()) {
+      return false;
+    }
+    for (size_t j = 0; j < a[i].size(); j++) {
+      if (a[i][j].second != b[i][j].second ||
+          std::abs(a[i][j].first - b[i][j].first) > tolerance) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool sameTopLabels(
+    const std::vector<Predictions>& a,
+    const std::vector<Predictions>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].empty() != b[i].empty() ||
+        (!a[i].empty() && a[i][0].second != b[i][0].second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void testStreamed(FastText& fasttext, const std::vector<std::string>& lines) {
+  const auto expected = predictAll(fasttext, lines, false);
+  check(
+      same(predictAll(fasttext, lines, true), expected, 1e-5),
+      "predictLineStreamed matches predictLine");
+  fasttext.setFoldDuplicates(true);
+  check(
+      same(predictAll(fasttext, lines, true), expected, 1e-5),
+      "predictLineStreamed with folded duplicates matches predictLine");
+  check(
+      same(predictAll(fasttext, lines, false), expected, 1e-5),
+      "predictLine with folded duplicates matches predictLine");
+  fasttext.setFoldDuplicates(false);
+}
+
+void testPrecomputed(
+    FastText& fasttext,
+    const std::vector<std::string>& lines,
+    const std::string& dir) {
+  const auto expected = predictAll(fasttext, lines, false);
+  const std::string path = dir + "/precomputed.bin";
+  fasttext.setPrecomputed(true);
+  fasttext.saveModel(path);
+  fasttext.setPrecomputed(false);
+
+  FastText loaded;
+  loaded.loadModel(path);
+  check(loaded.isPrecomputed(), "precomputed model is loaded precomputed");
+  check(
+      same(predictAll(loaded, lines, false), expected, 0),
+      "precomputed model predicts the same");
+}
+
+void testHalf(
+    const std::vector<std::string>& lines,
+    const std::string& dir) {
+  FastText fasttext;
+  fasttext.loadModel(dir + "/dense.bin");
+  const auto dense = predictAll(fasttext, lines, false);
+  fasttext.convertToHalf();
+  const auto expected = predictAll(fasttext, lines, false);
+  check(
+      same(expected, dense, 1e-2),
+      "half precision model predicts close to the dense one");
+  const std::string path = dir + "/half.bin";
+  fasttext.saveModel(path);
+
+  FastText loaded;
+  loaded.loadModel(path);
+  check(
+      loaded.getInputMatrixType() == matrix_type::half,
+      "half precision model is loaded as half precision");
+  check(
+      same(predictAll(loaded, lines, false), expected, 0),
+      "half precision model predicts the same after loading");
+  check(
+      same(predictAll(loaded, lines, true), expected, 1e-5),
+      "half precision model predicts the same streamed");
+}
+
+void testInt8(
+    const std::vector<std::string>& lines,
+    const std::string& dir) {
+  FastText fasttext;
+  fasttext.loadModel(dir + "/dense.bin");
+  const auto dense = predictAll(fasttext, lines, false);
+  Args qargs;
+  qargs.qint8 = true;
+  qargs.cutoff = 0;
+  qargs.retrain = false;
+  qargs.qout = false;
+  fasttext.quantize(qargs);
+  const auto expected = predictAll(fasttext, lines, false);
+  check(
+      sameTopLabels(expected, dense),
+      "int8 model predicts the labels of the dense one");
+  const std::string path = dir + "/int8.ftz";
+  fasttext.saveModel(path);
+
+  FastText loaded;
+  loaded.loadModel(path);
+  check(
+      loaded.getInputMatrixType() == matrix_type::int8,
+      "int8 model is loaded as int8");
+  check(
+      same(predictAll(loaded, lines, false), expected, 0),
+      "int8 model predicts the same after loading");
+  check(
+      same(predictAll(loaded, lines, true), expected, 1e-5),
+      "int8 model predicts the same streamed");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::string dir = argc > 1 ? argv[1] : ".";
+  std::minstd_rand rng(2);
+  const auto lines = makeLines(rng, 30);
+
+  FastText fasttext;
+  train(fasttext, dir);
+  fasttext.saveModel(dir + "/dense.bin");
+
+  testStreamed(fasttext, lines);
+  testPrecomputed(fasttext, lines, dir);
+  testHalf(lines, dir);
+  testInt8(lines, dir);
+
+  if (failures != 0) {
+    return EXIT_FAILURE;
+  }
+  std::cout << "model_test: OK" << std::endl;
+  return EXIT_SUCCESS;
+}
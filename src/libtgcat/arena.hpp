@@ -0,0 +1,87 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "config.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Scratch memory of a thread for the temporaries of one request. Allocations
+// are taken in order from a buffer the thread keeps and are given back all at
+// once when the outermost `Arena::Scope` ends. A request that outgrows the
+// buffer takes the rest from the heap, and the buffer is enlarged to the size
+// it needed, up to `Config::Arena::max_bytes`.
+class Arena final {
+public:
+  class Scope final {
+  public:
+    Scope() noexcept : _arena{local()} { ++_arena._depth; }
+    ~Scope() { if (--_arena._depth == 0) { _arena.release(); } }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    Arena& _arena;
+  };
+
+  static Arena& local() noexcept {
+    thread_local Arena arena;
+    return arena;
+  }
+
+  std::pmr::memory_resource *resource() noexcept { return &*_resource; }
+
+private:
+  // heap behind the buffer, counts the bytes the buffer did not cover
+  class Upstream final : public std::pmr::memory_resource {
+  public:
+    std::size_t bytes{0};
+
+  private:
+    void *do_allocate(const std::size_t size, const std::size_t alignment) override {
+      bytes += size;
+      return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void *p, const std::size_t size, const std::size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  std::unique_ptr<std::byte[]>                       _buffer;
+  std::size_t                                        _size{0};
+  Upstream                                           _upstream;
+  std::optional<std::pmr::monotonic_buffer_resource> _resource;
+  std::size_t                                        _depth{0};
+
+  Arena() { reserve(Config::Arena::initial_bytes); }
+
+  void reserve(const std::size_t size) {
+    std::unique_ptr<std::byte[]> buffer{new std::byte[size]};
+    _resource.reset();
+    _buffer = std::move(buffer);
+    _size = size;
+    _resource.emplace(_buffer.get(), _size, &_upstream);
+  }
+
+  void release() noexcept {
+    const auto needed = _size + _upstream.bytes;
+    _resource->release();
+    _upstream.bytes = 0;
+    if (needed > _size && _size < Config::Arena::max_bytes) {
+      try {
+        reserve(std::min<std::size_t>(needed, Config::Arena::max_bytes));
+      } catch (const std::bad_alloc&) {
+        // the current buffer is kept
+      }
+    }
+  }
+};
+
+#endif // ARENA_HPP
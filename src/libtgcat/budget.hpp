@@ -0,0 +1,78 @@
+#ifndef BUDGET_HPP
+#define BUDGET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+// Length of the longest prefix of the first `length` bytes of a UTF-8 string
+// that does not end within a code point.
+inline std::size_t utf8_prefix(const char *s, std::size_t length) noexcept {
+  while (length != 0 && (s[length] & 0xC0) == 0x80) {
+    --length;
+  }
+  return length;
+}
+
+using Posts = std::pmr::vector<std::string_view>;
+
+// Posts passed to the models after `used` bytes of title and description, all
+// of them while they fit into `channel_bytes`, 0 meaning unlimited. Over the
+// budget an even spread of posts is kept, as many as fit with
+// `min_post_bytes` each, and the longest of them are truncated to an equal
+// share of the space left.
+inline Posts select_posts(const std::size_t used, const char **posts, const std::size_t count,
+                          const std::size_t channel_bytes, const std::size_t min_post_bytes,
+                          std::pmr::memory_resource *resource) {
+  Posts selected{resource};
+  std::pmr::vector<std::size_t> lengths(count, resource);
+  std::size_t total{0};
+  for (std::size_t i = 0; i != count; ++i) {
+    lengths[i] = strlen(posts[i]);
+    total += lengths[i] + 1;
+  }
+  if (channel_bytes == 0 || used + total <= channel_bytes) {
+    selected.reserve(count);
+    for (std::size_t i = 0; i != count; ++i) {
+      selected.emplace_back(posts[i], lengths[i]);
+    }
+    return selected;
+  }
+  if (used >= channel_bytes) {
+    return selected;
+  }
+
+  auto space = channel_bytes - used;
+  const auto kept = std::min(count, std::max<std::size_t>(1, space / (min_post_bytes + 1)));
+  std::pmr::vector<std::size_t> indices(kept, resource);
+  for (std::size_t k = 0; k != kept; ++k) {
+    indices[k] = k * count / kept;
+  }
+
+  // the posts shorter than their share are kept whole, which leaves more
+  // space to the others
+  std::pmr::vector<std::size_t> by_length{indices, resource};
+  std::sort(by_length.begin(), by_length.end(),
+            [&lengths](const auto a, const auto b) { return lengths[a] < lengths[b]; });
+  auto cap{lengths[by_length.back()]};
+  for (std::size_t k = 0; k != kept; ++k) {
+    const auto share = space / (kept - k);
+    const auto length = lengths[by_length[k]];
+    if (length + 1 > share) {
+      cap = share > 0 ? share - 1 : 0;
+      break;
+    }
+    space -= length + 1;
+  }
+
+  selected.reserve(kept);
+  for (const auto i : indices) {
+    selected.emplace_back(posts[i], lengths[i] <= cap ? lengths[i] : utf8_prefix(posts[i], cap));
+  }
+  return selected;
+}
+
+#endif // BUDGET_HPP
@@ -1,20 +1,48 @@
 #ifndef CACHE_HPP
 #define CACHE_HPP
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class Cache final {
 public:
-  void set(const std::string& data, const std::string& code) noexcept { set_data(data); set_code(code); }
-  void set_data(const std::string& data) noexcept { _data = data; }
-  void set_code(const std::string& code) noexcept { _code = code; }
-  std::string get_data() const noexcept { return _data; }
-  std::string get_code() const noexcept { return _code; }
-  void reset() noexcept { _data.clear(); _code.clear(); }
+  void set(const std::string_view data, const std::string_view code) noexcept { set_data(data); set_code(code); }
+  void set_data(const std::string_view data) noexcept { _data.assign(data); }
+  void set_code(const std::string_view code) noexcept { _code.assign(code); }
+  const std::string& get_data() const noexcept { return _data; }
+  const std::string& get_code() const noexcept { return _code; }
+  void reset() noexcept { _data.clear(); _code.clear(); _posts.clear(); _posts_data.clear(); }
+
+  // Posts of the channel in order, by the hash of the raw post, with their
+  // preprocessed text if it was computed.
+  void add_post(const std::uint64_t key) { _posts.push_back({key, 0, Post::none}); }
+  void add_post(const std::uint64_t key, const std::string_view data) {
+    _posts.push_back({key, _posts_data.size(), data.size()});
+    _posts_data.append(data);
+  }
+  std::optional<std::string_view> get_post(const std::size_t i, const std::uint64_t key) const noexcept {
+    if (i >= _posts.size() || _posts[i].key != key || _posts[i].length == Post::none) {
+      return std::nullopt;
+    }
+    return std::string_view{_posts_data}.substr(_posts[i].offset, _posts[i].length);
+  }
 
 private:
-  std::string _data;
-  std::string _code;
+  struct Post {
+    static constexpr auto none = static_cast<std::size_t>(-1);
+
+    std::uint64_t key;
+    std::size_t   offset;
+    std::size_t   length;
+  };
+
+  std::string       _data;
+  std::string       _code;
+  std::vector<Post> _posts;
+  std::string       _posts_data;
 };
 
 #endif // CACHE_HPP
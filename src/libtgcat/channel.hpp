@@ -0,0 +1,147 @@
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+
+#include "script.hpp"
+
+#include "../../resources/fasttext/src/real.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Running state of a channel that is classified as it grows: the letter
+// histogram of its scripts and, for the language model and every category
+// model, the sum of the input rows of its text, their number, and the hashes
+// of the last words, which form word ngrams with the first words of the next
+// post. Nothing else has to be kept to append more posts.
+struct TgcatChannel {
+  struct Sum {
+    std::string                  code;  // empty for the language model
+    std::uint64_t                fingerprint{0};
+    int64_t                      count{0};
+    std::vector<fasttext::real>  sum;
+    std::vector<int32_t>         window;  // at most wordNgrams - 1 hashes
+  };
+
+  ScriptHistogram   script;
+  std::uint64_t     posts{0};
+  std::vector<Sum>  sums;
+
+  const Sum *find(const std::string_view code) const noexcept {
+    for (const auto& sum : sums) {
+      if (sum.code == code) {
+        return &sum;
+      }
+    }
+    return nullptr;
+  }
+
+  // Bytes of the serialized state, in the byte order of the host:
+  // magic, posts, script counters, then code, fingerprint, count, sum and
+  // word window of every model.
+  std::size_t serialized_size() const noexcept {
+    auto size = sizeof(MAGIC) + sizeof(posts) + ScriptHistogram::size() * sizeof(std::uint64_t) +
+                sizeof(std::uint32_t);
+    for (const auto& sum : sums) {
+      size += sizeof(std::uint8_t) + sum.code.size() + sizeof(sum.fingerprint) +
+              sizeof(sum.count) + sizeof(std::uint32_t) + sum.sum.size() * sizeof(fasttext::real) +
+              sizeof(std::uint8_t) + sum.window.size() * sizeof(int32_t);
+    }
+    return size;
+  }
+
+  void serialize(unsigned char *out) const noexcept {
+    write(out, MAGIC);
+    write(out, posts);
+    std::uint64_t counters[ScriptHistogram::size()];
+    script.save(counters);
+    write(out, counters, sizeof(counters));
+    write(out, static_cast<std::uint32_t>(sums.size()));
+    for (const auto& sum : sums) {
+      write(out, static_cast<std::uint8_t>(sum.code.size()));
+      write(out, sum.code.data(), sum.code.size());
+      write(out, sum.fingerprint);
+      write(out, sum.count);
+      write(out, static_cast<std::uint32_t>(sum.sum.size()));
+      write(out, sum.sum.data(), sum.sum.size() * sizeof(fasttext::real));
+      write(out, static_cast<std::uint8_t>(sum.window.size()));
+      write(out, sum.window.data(), sum.window.size() * sizeof(int32_t));
+    }
+  }
+
+  // State read from `serialize()` output, `nullptr` if it is malformed or if
+  // its first sum is not the one of the language model.
+  static std::unique_ptr<TgcatChannel> deserialize(const unsigned char *in, std::size_t size) {
+    auto channel = std::make_unique<TgcatChannel>();
+    std::uint32_t magic;
+    std::uint64_t counters[ScriptHistogram::size()];
+    std::uint32_t count;
+    if (!read(in, size, magic) || magic != MAGIC || !read(in, size, channel->posts) ||
+        !read(in, size, counters, sizeof(counters)) || !read(in, size, count)) {
+      return nullptr;
+    }
+    channel->script.load(counters);
+    for (std::uint32_t i{0}; i != count; ++i) {
+      Sum sum;
+      std::uint8_t code_size;
+      std::uint32_t dimension;
+      std::uint8_t window_size;
+      if (!read(in, size, code_size) || size < code_size) {
+        return nullptr;
+      }
+      sum.code.assign(reinterpret_cast<const char *>(in), code_size);
+      in += code_size;
+      size -= code_size;
+      if (!read(in, size, sum.fingerprint) || !read(in, size, sum.count) ||
+          !read(in, size, dimension) || size / sizeof(fasttext::real) < dimension) {
+        return nullptr;
+      }
+      sum.sum.resize(dimension);
+      read(in, size, sum.sum.data(), dimension * sizeof(fasttext::real));
+      if (!read(in, size, window_size)) {
+        return nullptr;
+      }
+      sum.window.resize(window_size);
+      if (!read(in, size, sum.window.data(), window_size * sizeof(int32_t))) {
+        return nullptr;
+      }
+      channel->sums.push_back(std::move(sum));
+    }
+    if (size != 0 || channel->sums.empty() || !channel->sums.front().code.empty()) {
+      return nullptr;
+    }
+    return channel;
+  }
+
+private:
+  static constexpr std::uint32_t MAGIC = 0x48434754; // "TGCH"
+
+  template <typename T>
+  static void write(unsigned char *& out, const T& value) noexcept {
+    write(out, &value, sizeof(value));
+  }
+  static void write(unsigned char *& out, const void *data, const std::size_t size) noexcept {
+    std::memcpy(out, data, size);
+    out += size;
+  }
+
+  template <typename T>
+  static bool read(const unsigned char *& in, std::size_t& size, T& value) noexcept {
+    return read(in, size, &value, sizeof(value));
+  }
+  static bool read(const unsigned char *& in, std::size_t& size, void *data,
+                   const std::size_t n) noexcept {
+    if (size < n) {
+      return false;
+    }
+    std::memcpy(data, in, n);
+    in += n;
+    size -= n;
+    return true;
+  }
+};
+
+#endif // CHANNEL_HPP
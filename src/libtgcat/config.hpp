@@ -12,11 +12,84 @@ namespace Language::Model {
 static constexpr auto language = "../../models/sl_language";
 static constexpr auto category_en = "../../models/sl_category_en";
 static constexpr auto category_ru = "../../models/sl_category_ru";
+
+struct Category {
+  const char *code;
+  const char *path;
+};
+
+static constexpr Category categories[] = {
+  {Code::English, category_en},
+  {Code::Russian, category_ru},
+};
 } // Language::Model
 
+namespace Registry {
+// bytes of category models kept in memory, estimated by their file sizes;
+// least recently used models are evicted beyond it, 0 means unlimited
+static constexpr auto memory_budget = 0UL;
+} // Registry
+
+namespace Predictor {
+// add the row of a token repeated in a channel once, scaled by its count;
+// pays off only for texts with heavy repetition
+static constexpr auto fold_duplicates = false;
+} // Predictor
+
+namespace PostCache {
+// sums of the input rows of posts each model keeps, keyed by a hash of the
+// post; with it channels are embedded one post at a time, so word ngrams
+// across posts are left out; it pays off only when the same posts come back
+// in several requests, e.g. 1UL << 16; 0 disables it
+static constexpr auto capacity = 0UL;
+} // PostCache
+
+namespace ResultCache {
+// language and categories of channels by a hash of their title, description
+// and posts, served again for up to `ttl_seconds`, e.g. 1UL << 14; 0 capacity
+// disables it
+static constexpr auto capacity = 0UL;
+static constexpr auto shards = 16UL;
+static constexpr auto ttl_seconds = 3600UL;
+} // ResultCache
+
+namespace Startup {
+// load times of the models printed to stderr by init, for profiling
+static constexpr auto report = false;
+} // Startup
+
+namespace Script {
+// the language is named from the script of the channel when at least
+// `min_letters` letters are in one script of a single language, with a share
+// of at least `min_share`; calibrated on resources/test-data/all_annotated.tsv,
+// where it decides 2% of the tweets and agrees with lid.176 on 98.6% of them
+static constexpr auto enabled = true;
+static constexpr auto min_letters = 16UL;
+static constexpr auto min_share = 0.7;
+} // Script
+
+namespace Budget {
+// bytes of channel text passed to the models, e.g. 16384UL, 0 means
+// unlimited; title and description are always kept whole and posts are picked
+// from the space left, see `select_posts()`
+static constexpr auto channel_bytes = 0UL;
+static constexpr auto min_post_bytes = 256UL;
+} // Budget
+
+namespace Arena {
+// scratch memory each thread keeps for the temporaries of a request, see
+// `Arena`; it grows to what the largest request needed, up to `max_bytes`
+static constexpr auto initial_bytes = 256UL * 1024;
+static constexpr auto max_bytes = 4UL * 1024 * 1024;
+} // Arena
+
 namespace Randomized {
 static constexpr auto posts_threshold = 10UL;
 static constexpr auto no_of_passes = 5UL;
+// a pass whose top-1 probability exceeds the second one by this margin ends
+// the voting if its language leads; probabilities, not log-probabilities, are
+// compared, so a value above 1 disables it
+static constexpr auto early_exit_margin = 0.9f;
 } // Randomized
 
 } // Config
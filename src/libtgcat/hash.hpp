@@ -0,0 +1,43 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// 64-bit hash of a byte string, MurmurHash64A; 8 bytes are mixed at a time.
+inline std::uint64_t hash_bytes(const std::string_view data,
+                                const std::uint64_t seed = 0) noexcept {
+  constexpr std::uint64_t m = 0xc6a4a7935bd1e995ULL;
+  constexpr int r = 47;
+  const auto *s = reinterpret_cast<const unsigned char *>(data.data());
+  const auto length = data.size();
+  std::uint64_t h = seed ^ (length * m);
+
+  const auto *end = s + (length & ~std::size_t{7});
+  for (; s != end; s += 8) {
+    std::uint64_t k;
+    std::memcpy(&k, s, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  switch (length & 7) {
+  case 7: h ^= std::uint64_t{s[6]} << 48; [[fallthrough]];
+  case 6: h ^= std::uint64_t{s[5]} << 40; [[fallthrough]];
+  case 5: h ^= std::uint64_t{s[4]} << 32; [[fallthrough]];
+  case 4: h ^= std::uint64_t{s[3]} << 24; [[fallthrough]];
+  case 3: h ^= std::uint64_t{s[2]} << 16; [[fallthrough]];
+  case 2: h ^= std::uint64_t{s[1]} << 8;  [[fallthrough]];
+  case 1: h ^= std::uint64_t{s[0]};
+          h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+#endif // HASH_HPP
@@ -0,0 +1,139 @@
+#ifndef LAZY_PREDICTOR_HPP
+#define LAZY_PREDICTOR_HPP
+
+#include "predictor.hpp"
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Predictor which is loaded either on its first use or on a background thread.
+// Once loaded, the predictor can be replaced by a freshly loaded one; readers
+// keep using the instance they got until they drop their reference.
+class LazyPredictor final {
+public:
+  using Predictor_t = std::shared_ptr<Predictor>;
+
+  LazyPredictor(std::string name, std::string model_path)
+    : _name{std::move(name)}, _model_path{std::move(model_path)} {}
+
+  // Starts loading on a background thread unless loading has already started.
+  void prefetch() { start(std::launch::async); }
+
+  // Loads the model unless loading has already started and blocks until it
+  // is ready. Rethrows the exception of a failed load, which is dropped so
+  // that the next request loads the model again.
+  Predictor_t wait() {
+    std::size_t generation;
+    const auto future = start(std::launch::deferred, generation);
+    Predictor_t loaded;
+    try {
+      loaded = future.get();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock{_mutex};
+      // the waiters of the same failed load drop it once
+      if (generation == _generation) {
+        _future = {};
+        ++_generation;
+      }
+      throw;
+    }
+    std::lock_guard<std::mutex> lock{_mutex};
+    // an eviction or a reload in the meantime must not be overwritten
+    if (generation != _generation) {
+      return loaded;
+    }
+    if (auto current = std::atomic_load(&_current)) {
+      return current;
+    }
+    std::atomic_store(&_current, loaded);
+    return loaded;
+  }
+
+  // Same as `wait()` but returns `nullptr` if loading failed.
+  Predictor_t get() noexcept {
+    if (auto current = std::atomic_load(&_current)) {
+      return current;
+    }
+    try {
+      return wait();
+    } catch (const std::exception&) {
+      return nullptr;
+    }
+  }
+
+  // Current instance without triggering a load, `nullptr` if not loaded.
+  Predictor_t loaded() const noexcept { return std::atomic_load(&_current); }
+
+  // Drops the loaded instance, the next request loads the model again.
+  // Requests in flight finish on the dropped instance.
+  void evict() {
+    std::lock_guard<std::mutex> lock{_mutex};
+    std::atomic_store(&_current, Predictor_t{nullptr});
+    _future = {};
+    ++_generation;
+  }
+
+  // Number of times the model has been loaded.
+  std::size_t loads() const noexcept { return _loads; }
+
+  // Starts loading a fresh instance of the model, e.g. after its file has been
+  // replaced. Returns an invalid future if the model has never been requested.
+  std::future<Predictor_t> reload() {
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      if (!_future.valid()) {
+        return {};
+      }
+    }
+    return std::async(std::launch::async, [this] { return load(); });
+  }
+
+  // Publishes a reloaded instance. Requests in flight finish on the previous
+  // one, which is released together with its last reference.
+  void publish(Predictor_t predictor) {
+    if (!predictor) {
+      return;
+    }
+    std::promise<Predictor_t> ready;
+    ready.set_value(predictor);
+    std::lock_guard<std::mutex> lock{_mutex};
+    std::atomic_store(&_current, predictor);
+    _future = ready.get_future().share();
+    ++_generation;
+  }
+
+private:
+  std::string                      _name;
+  std::string                      _model_path;
+  std::mutex                       _mutex;
+  std::shared_future<Predictor_t>  _future;
+  std::size_t                      _generation{0};  // bumped by evict, publish and failed loads
+  Predictor_t                      _current{nullptr};
+  std::atomic<std::size_t>         _loads{0};
+
+  Predictor_t load() {
+    auto predictor = std::make_shared<Predictor>(_name, _model_path);
+    ++_loads;
+    return predictor;
+  }
+
+  std::shared_future<Predictor_t> start(const std::launch policy) {
+    std::size_t generation;
+    return start(policy, generation);
+  }
+
+  std::shared_future<Predictor_t> start(const std::launch policy,
+                                        std::size_t& generation) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (!_future.valid()) {
+      _future = std::async(policy, [this] { return load(); });
+    }
+    generation = _generation;
+    return _future;
+  }
+};
+
+#endif // LAZY_PREDICTOR_HPP
@@ -0,0 +1,151 @@
+#ifndef LRU_CACHE_HPP
+#define LRU_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Heap memory a value owns besides its own size, for the memory estimate of
+// `LruCache`; values owning memory overload it.
+template <typename Value>
+std::size_t owned_bytes(const Value&) noexcept { return 0; }
+
+// Least recently used values keyed by 64-bit hashes. The keys are split into
+// shards that are locked independently, each holding up to its share of the
+// capacity, so threads rarely wait for each other. Values may expire a fixed
+// time after they are inserted.
+template <typename Value>
+class LruCache final {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Stats {
+    std::size_t hits{0};
+    std::size_t misses{0};
+    std::size_t size{0};
+    // estimated bytes of the cached values and of their bookkeeping
+    std::size_t memory{0};
+  };
+
+  // `capacity` in values, 0 disables the cache; `ttl` of 0 keeps values
+  // until they are evicted.
+  explicit LruCache(const std::size_t capacity, const std::size_t shards = 16,
+                    const Clock::duration ttl = Clock::duration::zero())
+    : _shard_count{capacity == 0 ? 1 : std::min(shards, capacity)},
+      _shard_capacity{(capacity + _shard_count - 1) / _shard_count},
+      _ttl{ttl},
+      _shards{std::make_unique<Shard[]>(_shard_count)} {}
+
+  // Calls `f` with the value of `key`, with its shard locked, and marks it as
+  // the most recently used. Returns false if the key is not cached or its
+  // value expired.
+  template <typename F>
+  bool find(const std::uint64_t key, F&& f) {
+    auto& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      ++_misses;
+      return false;
+    }
+    if (_ttl != Clock::duration::zero() && it->second->expires <= Clock::now()) {
+      shard.erase(it);
+      ++_misses;
+      return false;
+    }
+    shard.order.splice(shard.order.begin(), shard.order, it->second);
+    f(it->second->value);
+    ++_hits;
+    return true;
+  }
+
+  // Caches `value` under `key`, replacing a previous value, and evicts the
+  // least recently used value of the shard if it is full.
+  void insert(const std::uint64_t key, Value value) {
+    if (_shard_capacity == 0) {
+      return;
+    }
+    const auto expires = _ttl != Clock::duration::zero() ? Clock::now() + _ttl : Clock::time_point{};
+    auto& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    if (const auto it = shard.index.find(key); it != shard.index.end()) {
+      shard.erase(it);
+    } else if (shard.order.size() == _shard_capacity) {
+      shard.erase(shard.index.find(shard.order.back().key));
+    }
+    shard.order.push_front({key, std::move(value), expires});
+    shard.index.emplace(key, shard.order.begin());
+    shard.memory += footprint(shard.order.front().value);
+  }
+
+  // Drops every value, counters are kept.
+  void clear() {
+    for (std::size_t i{0}; i != _shard_count; ++i) {
+      std::lock_guard<std::mutex> lock{_shards[i].mutex};
+      _shards[i].order.clear();
+      _shards[i].index.clear();
+      _shards[i].memory = 0;
+    }
+  }
+
+  Stats stats() const noexcept {
+    Stats stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    for (std::size_t i{0}; i != _shard_count; ++i) {
+      std::lock_guard<std::mutex> lock{_shards[i].mutex};
+      stats.size += _shards[i].order.size();
+      stats.memory += _shards[i].memory;
+    }
+    return stats;
+  }
+
+private:
+  struct Entry {
+    std::uint64_t     key;
+    Value             value;
+    Clock::time_point expires;
+  };
+  using Entries = std::list<Entry>;
+  using Index = std::unordered_map<std::uint64_t, typename Entries::iterator>;
+
+  struct Shard {
+    mutable std::mutex  mutex;
+    Entries             order;
+    Index               index;
+    std::size_t         memory{0};
+
+    void erase(const typename Index::iterator it) {
+      memory -= footprint(it->second->value);
+      order.erase(it->second);
+      index.erase(it);
+    }
+  };
+
+  const std::size_t         _shard_count;
+  const std::size_t         _shard_capacity;
+  const Clock::duration     _ttl;
+  std::unique_ptr<Shard[]>  _shards;
+  std::atomic<std::size_t>  _hits{0};
+  std::atomic<std::size_t>  _misses{0};
+
+  // a list node and an index node per value
+  static std::size_t footprint(const Value& value) noexcept {
+    constexpr auto node = sizeof(Entry) + 2 * sizeof(void *);
+    constexpr auto index_node = sizeof(typename Index::value_type) + 2 * sizeof(void *);
+    return node + index_node + owned_bytes(value);
+  }
+
+  // the high bits pick the shard, the low ones the bucket within it
+  Shard& shard_of(const std::uint64_t key) noexcept {
+    return _shards[(key >> 32) % _shard_count];
+  }
+};
+
+#endif // LRU_CACHE_HPP
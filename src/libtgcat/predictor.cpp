@@ -1,25 +1,186 @@
 #include "predictor.hpp"
+#include "config.hpp"
+#include "hash.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
-#include <sstream>
+#include <streambuf>
+#include <vector>
 
-Predictor::Predictor(const std::string name, const std::string model_path) : _name{name} {
+namespace {
+
+// Input stream buffer over a string that is read in place, unlike
+// `std::istringstream` which copies it.
+class ViewBuffer final : public std::streambuf {
+public:
+  explicit ViewBuffer(const std::string_view data) noexcept {
+    const auto begin = const_cast<char *>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+
+protected:
+  pos_type seekpos(const pos_type pos, std::ios_base::openmode) override {
+    if (pos < 0 || pos > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + pos, egptr());
+    return pos;
+  }
+};
+
+// Fingerprint of a loaded model: the size and modification time of its file
+// and the shape and labels of the model, without reading the file again.
+std::uint64_t fingerprint_of(const std::string& path, const FastText& ft) {
+  const std::filesystem::path file{path};
+  const std::uint64_t stat[] = {
+      static_cast<std::uint64_t>(std::filesystem::file_size(file)),
+      static_cast<std::uint64_t>(std::filesystem::last_write_time(file).time_since_epoch().count())};
+  const auto& args = ft.getArgs();
+  const auto dict = ft.getDictionary();
+  const std::int64_t shape[] = {args.dim, args.wordNgrams, args.minn, args.maxn, args.bucket,
+                                dict->nwords(), dict->nlabels(), dict->ntokens()};
+  auto hash = hash_bytes({reinterpret_cast<const char *>(stat), sizeof(stat)});
+  hash = hash_bytes({reinterpret_cast<const char *>(shape), sizeof(shape)}, hash);
+  for (int32_t i = 0; i != dict->nlabels(); ++i) {
+    hash = hash_bytes(dict->getLabel(i), hash);
+  }
+  return hash;
+}
+
+// Probabilities of the labels of a model, one buffer per thread which is
+// reallocated only for a model with another number of labels.
+Vector& label_probabilities(const std::size_t size) {
+  thread_local Vector probabilities(0);
+  if (static_cast<std::size_t>(probabilities.size()) != size) {
+    probabilities = Vector(size);
+  }
+  return probabilities;
+}
+
+} // namespace
+
+Predictor::Predictor(const std::string name, const std::string model_path)
+  : _name{name}, _post_cache{Config::PostCache::capacity} {
+  _ft.setFoldDuplicates(Config::Predictor::fold_duplicates);
   if (!loadModel(model_path)) {
     throw std::runtime_error{_name + " | Initalization failed!"};
   }
 }
 
-std::vector<std::pair<real, std::string>>
-Predictor::predict(const std::string& data, const int32_t k, const real threshold) noexcept {
-  std::istringstream iss{data};
-  std::vector<std::pair<real, std::string>> predictions;
-  _ft.predictLine(iss, predictions, k, threshold);
+Predictions
+Predictor::predict(const std::string_view data, const int32_t k, const real threshold) noexcept {
+  ViewBuffer buffer{data};
+  std::istream iss{&buffer};
+  Predictions predictions;
+  if (Config::Predictor::fold_duplicates) {
+    _ft.predictLine(iss, predictions, k, threshold);
+  } else {
+    _ft.predictLineStreamed(iss, predictions, k, threshold);
+  }
   return predictions;
 }
 
+bool Predictor::predict_distribution(const std::string_view data, double *distribution,
+                                     const std::size_t size) noexcept {
+  ViewBuffer buffer{data};
+  std::istream iss{&buffer};
+  auto& probabilities = label_probabilities(_categories.size());
+  if (!_ft.predictLineDistribution(iss, probabilities)) {
+    return false;
+  }
+  scatter(probabilities, distribution, size);
+  return true;
+}
+
+Predictions Predictor::predict(const Vector& sum, const int64_t count, const int32_t k,
+                               const real threshold) noexcept {
+  Predictions predictions;
+  _ft.predict(k, sum, count, predictions, threshold);
+  for (auto& p : predictions) {
+    p.first = std::exp(p.first);
+  }
+  return predictions;
+}
+
+bool Predictor::predict_distribution(const Vector& sum, const int64_t count,
+                                     double *distribution, const std::size_t size) noexcept {
+  auto& probabilities = label_probabilities(_categories.size());
+  if (!_ft.predictDistribution(sum, count, probabilities)) {
+    return false;
+  }
+  scatter(probabilities, distribution, size);
+  return true;
+}
+
+int64_t Predictor::embed(const std::string_view data, Vector& sum) const noexcept {
+  ViewBuffer buffer{data};
+  std::istream iss{&buffer};
+  if (iss.peek() == EOF) {
+    return 0;
+  }
+  return _ft.addLineToVector(iss, sum);
+}
+
+int64_t Predictor::embed(const std::string_view data, Vector& sum,
+                         std::vector<int32_t>& window) const noexcept {
+  ViewBuffer buffer{data};
+  std::istream iss{&buffer};
+  if (iss.peek() == EOF) {
+    return 0;
+  }
+  return _ft.addLineToVector(iss, sum, window);
+}
+
+int64_t Predictor::add_cached_post(const std::uint64_t key, Vector& sum) noexcept {
+  int64_t count{-1};
+  _post_cache.find(key, [&sum, &count](const PostSum& post) {
+    for (int64_t i = 0; i != sum.size(); ++i) {
+      sum[i] += post.sum[i];
+    }
+    count = post.count;
+  });
+  return count;
+}
+
+int64_t Predictor::add_post(const std::uint64_t key, const std::string_view data,
+                            Vector& sum) noexcept {
+  Vector post(sum.size());
+  post.zero();
+  const auto count = embed(data, post);
+  sum.addVector(post);
+  try {
+    _post_cache.insert(key, {{post.data(), post.data() + post.size()}, count});
+  } catch (const std::bad_alloc&) {
+    // the post is not cached
+  }
+  return count;
+}
+
+void Predictor::scatter(const Vector& probabilities, double *distribution,
+                        const std::size_t size) const noexcept {
+  auto sum = 0.0f;
+  for (int64_t i = 0; i != probabilities.size(); ++i) {
+    sum += probabilities[i];
+  }
+  for (int64_t i = 0; i != probabilities.size(); ++i) {
+    const auto index = _categories[i];
+    if (index >= 0 && static_cast<std::size_t>(index) < size) {
+      distribution[index] = probabilities[i] / sum;
+    }
+  }
+}
+
 bool Predictor::loadModel(const std::string& path) noexcept {
   try {
+    const auto start = std::chrono::steady_clock::now();
     _ft.loadModel(path);
+    _load_time = utils::getDuration(start, std::chrono::steady_clock::now());
+    map_labels();
+    _fingerprint = fingerprint_of(path, _ft);
   } catch (const std::exception& ex) {
     std::cerr << _name
               << " | Exception: Unable to load model! [" << path << "] "
@@ -28,3 +189,22 @@ bool Predictor::loadModel(const std::string& path) noexcept {
   }
   return true;
 }
+
+void Predictor::map_labels() {
+  const auto dict = _ft.getDictionary();
+  const auto nlabels = dict->nlabels();
+  _categories.assign(nlabels, -1);
+  _language_codes.assign(nlabels, "other");
+  for (int32_t i = 0; i != nlabels; ++i) {
+    const auto label = dict->getLabel(i).substr(9); // skip __label__
+    if (!label.empty() && std::all_of(label.begin(), label.end(),
+                                      [](const unsigned char c) { return std::isdigit(c); })) {
+      _categories[i] = std::stoi(label);
+    }
+    // support only 2-letter language codes
+    // `sh` is not in the Wikipedia ISO 639-1 list so it is not considered
+    if (label.length() == 2 && label != "sh") {
+      _language_codes[i] = label;
+    }
+  }
+}
@@ -2,20 +2,88 @@
 #define PREDICTOR_HPP
 
 #include "../../resources/fasttext/src/fasttext.h"
+#include "lru_cache.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
 using namespace fasttext;
 
 class Predictor final {
 public:
+  // Sum of the input rows of a post and their number.
+  struct PostSum {
+    std::vector<real> sum;
+    int64_t           count{0};
+
+    friend std::size_t owned_bytes(const PostSum& post) noexcept {
+      return post.sum.capacity() * sizeof(real);
+    }
+  };
+  using PostCache = LruCache<PostSum>;
+
   Predictor(const std::string name, const std::string model_path);
 
-  std::vector<std::pair<real, std::string>>
-  predict(const std::string& data, const int32_t k = 1, const real threshold = 0.0) noexcept;
+  // Probabilities, not log-probabilities, with label ids, which index
+  // `category()` and `language_code()`.
+  Predictions predict(const std::string_view data, const int32_t k = 1, const real threshold = 0.0) noexcept;
+
+  // Normalized probabilities of all labels scattered into `distribution` by
+  // category, without ranking them. Returns false if nothing was predicted.
+  bool predict_distribution(const std::string_view data, double *distribution, const std::size_t size) noexcept;
+
+  // Same as above for the sum of `count` input rows, see `embed()`; the
+  // predictions are probabilities too.
+  Predictions predict(const Vector& sum, const int64_t count, const int32_t k = 1,
+                      const real threshold = 0.0) noexcept;
+  bool predict_distribution(const Vector& sum, const int64_t count, double *distribution,
+                            const std::size_t size) noexcept;
+
+  // Adds the input rows of a preprocessed text to `sum`, returns their number.
+  int64_t embed(const std::string_view data, Vector& sum) const noexcept;
+  // Same as above for a text continuing an earlier one, `window` carries the
+  // hashes of the last words for the word ngrams across them.
+  int64_t embed(const std::string_view data, Vector& sum, std::vector<int32_t>& window) const noexcept;
+  // Adds the rows of the post cached under `key` to `sum`, returns their
+  // number or -1 if the post is not cached.
+  int64_t add_cached_post(const std::uint64_t key, Vector& sum) noexcept;
+  // Embeds a preprocessed post, caches its rows under `key` and adds them to
+  // `sum`, returns their number.
+  int64_t add_post(const std::uint64_t key, const std::string_view data, Vector& sum) noexcept;
+  PostCache::Stats post_cache_stats() const noexcept { return _post_cache.stats(); }
+
+  int dimension() const noexcept { return _ft.getDimension(); }
+  int word_ngrams() const noexcept { return _ft.getArgs().wordNgrams; }
+  // Hash of the size and modification time of the model file and of the
+  // shape and labels of the model, tells sums of input rows of another model
+  // apart, including a retrained one of the same shape.
+  std::uint64_t fingerprint() const noexcept { return _fingerprint; }
+
+  // Category of a label, -1 if the label is not a category number.
+  int category(const int32_t label) const noexcept { return _categories[label]; }
+  // Code of a label if it is a supported language code, `other` otherwise.
+  const std::string& language_code(const int32_t label) const noexcept { return _language_codes[label]; }
+
+  const std::string& name() const noexcept { return _name; }
+  double load_time() const noexcept { return _load_time; }
+  const FastText::LoadProfile& load_profile() const noexcept { return _ft.getLoadProfile(); }
 
 private:
   std::string _name{"Predictor"};
   FastText    _ft;
+  double      _load_time{0.0};
+  std::uint64_t _fingerprint{0};
+
+  // label id -> mapping, computed once at load
+  std::vector<int>          _categories;
+  std::vector<std::string>  _language_codes;
+
+  PostCache _post_cache;
 
   bool loadModel(const std::string& path) noexcept;
+  void map_labels();
+  // normalizes label probabilities and scatters them by category
+  void scatter(const Vector& probabilities, double *distribution, const std::size_t size) const noexcept;
 };
 
 #endif // PREDICTOR_HPP
@@ -1,9 +1,11 @@
 #include "preprocessor.hpp"
 
 #include <iostream>
+#include <iterator>
 #include <regex>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
 
 // public interface
 
@@ -23,7 +25,10 @@ Preprocessor::~Preprocessor() {
   }
 }
 
-std::string Preprocessor::preprocess(std::string data) noexcept {
+Preprocessor::String
+Preprocessor::preprocess(const std::string_view data_view,
+                         std::pmr::memory_resource *resource) noexcept {
+  String data{data_view, resource};
   try {
     data = preprocess_emojis(data);
     data = preprocess_email(data);
@@ -39,7 +44,7 @@ std::string Preprocessor::preprocess(std::string data) noexcept {
     return data;
   }
 
-  std::string output;
+  String output{resource};
   output.reserve(data.size());
 
   for (const char ch : data) {
@@ -69,35 +74,63 @@ bool Preprocessor::set_up_file() noexcept {
   return true;
 }
 
-void Preprocessor::dump(std::string data) noexcept {
+void Preprocessor::dump(const std::string_view data) noexcept {
   if (is_debug()) {
-    data += '\n';
-    _file.write(data.c_str(), data.size());
+    _file.write(data.data(), data.size());
+    _file.put('\n');
     _file.flush();
   }
 }
 
+// Same as `std::regex_replace()`, the result and the matches are allocated
+// like `s`.
+static
+Preprocessor::String replace(const Preprocessor::String& s, const std::regex& r,
+                             const char *format) {
+  using Iterator = Preprocessor::String::const_iterator;
+  using Allocator = std::pmr::polymorphic_allocator<std::sub_match<Iterator>>;
+  Preprocessor::String output{s.get_allocator()};
+  output.reserve(s.size());
+  std::match_results<Iterator, Allocator> match{Allocator{s.get_allocator()}};
+  auto first = s.begin();
+  auto flags = std::regex_constants::match_default;
+  while (std::regex_search(first, s.end(), match, r, flags)) {
+    output.append(first, match[0].first);
+    match.format(std::back_inserter(output), format, format + std::strlen(format));
+    first = match[0].second;
+    if (match[0].first == match[0].second) {
+      if (first == s.end()) {
+        break;
+      }
+      output += *first++;
+    }
+    flags = std::regex_constants::match_prev_avail;
+  }
+  output.append(first, s.end());
+  return output;
+}
+
 // preprocess variants
 
-std::string Preprocessor::preprocess_email(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_email(const String& s) const {
   static const auto re = R"re((\w+)(\.|_)?(\w*)@(\w+)(\.(\w+))+)re";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, "");
+  return replace(s, r, "");
 }
 
-std::string Preprocessor::preprocess_username(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_username(const String& s) const {
   static const auto re = R"re(@(\w+))re";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, "");
+  return replace(s, r, "");
 }
 
-std::string Preprocessor::preprocess_links(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_links(const String& s) const {
   static const auto re = "https?://[^ ]+";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, "");
+  return replace(s, r, "");
 }
 
-std::string Preprocessor::preprocess_emojis_deletion(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_emojis_deletion(const String& s) const {
   static const auto re =
     "🇷🇺|🍕|🐵|😑|😢|🐶️|😜|😎|👊|😁|😍|💖|💵|👎|😀|😂|🔥|😄|💥|😋|👏|😱|🚌|🌟|😊|😳|😧|🙀|😐|😕|"
     "👍|😮|😃|😘|💩|💯|⛽|🚄|😖|🚲|😟|😈|💪|🙏|🎯|🌹|😇|💔|😡|👌|🙄|😠|😉|😤|⛺|🙂|👮|💙|😏|🍾|"
@@ -113,10 +146,10 @@ std::string Preprocessor::preprocess_emojis_deletion(const std::string& s) const
     "↴|💒|⊘|Ȼ|🚴|🖕|🖤|🥘|📍|👈|➕|🚫|🎨|🌑|🐻|🤖|🎎|😼|🕷|🇴🇭|👼|📉|🍟|🍦|🌈|🔭|《|🐊|🐍|🐦|"
     "🐡|💳|🙇|🥜|🔼|✋|⭐|⏩|✊|✨|❓|❗|✅|❌|⭕|⚾|⚽|😸|🥰";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, " ");
+  return replace(s, r, " ");
 }
 
-std::string Preprocessor::preprocess_emojis_isolation(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_emojis_isolation(const String& s) const {
   static const auto re =
     "・ω+=”“^–>°<~•≠™ˈʊɒ∞§·τα❤☺ɡ|¢→̶`❥━┣┫┗Ｏ►★©―ɪ✔®\x96\x92●£♥➤´¹☕≈÷♡◐║▬′ɔː€۩۞†μ✒➥═☆ˌ◄½ʻπδηλσερνʃ✬"
     "ＳＵＰＥＲＩＴ☻±♍µº¾✓◾؟．⬅℅»Вав❣⋅¿¬♫ＣＭβ█▓▒░⇒›¡₂₃❧▰▔◞▀▂▃▄▅▆▇↙γ̄″☹➡«φ⅓„：¥̲̅́∙‛◇✏▷¶˚˙）сиʿ。ɑ"
@@ -124,16 +157,16 @@ std::string Preprocessor::preprocess_emojis_isolation(const std::string& s) cons
     "▸■⇌☐☑⚡☄ǫ╭∩╮，例＞ʕɐ̣Δ₀✞┈╱╲▏▕┃╰▊▋╯┳┊≥☒↑☝ɹ☛♩☞ＡＪＢ◔◡↓♀⬆̱ℏ\x91⠀ˤ╚↺⇤∏✾◦♬³の｜／∵∴√Ω¤☜▲↳▫‿⬇✧ｏｖｍ－"
     "２０８＇‰≤∕ˆ⚜☁";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, " ");
+  return replace(s, r, " ");
 }
 
-std::string Preprocessor::preprocess_emojis(std::string s) const {
-  s = preprocess_emojis_deletion(s);
-  // s = preprocess_emojis_isolation(s);
-  return s;
+Preprocessor::String Preprocessor::preprocess_emojis(const String& s) const {
+  auto output = preprocess_emojis_deletion(s);
+  // output = preprocess_emojis_isolation(output);
+  return output;
 }
 
-std::string Preprocessor::preprocess_stop_words_en(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_stop_words_en(const String& s) const {
   static const auto re =
     "'ll|'tis|'twas|'ve|10|39|a|a's|able|ableabout|about|above|abroad|abst|"
     "accordance|according|accordingly|across|act|actually|ad|added|adj|adopted|"
@@ -233,10 +266,10 @@ std::string Preprocessor::preprocess_stop_words_en(const std::string& s) const {
     "yes|yet|you|you'd|you'll|you're|you've|youd|youll|young|younger|youngest|your|youre|"
     "yours|yourself|yourselves|youve|yt|yu|z|za|zero|zm|zr";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, "");
+  return replace(s, r, "");
 }
 
-std::string Preprocessor::preprocess_stop_words_ru(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_stop_words_ru(const String& s) const {
   static const auto re =
     "а|е|и|ж|м|о|на|не|ни|об|но|он|мне|мои|мож|она|они|оно|мной|много|многочисленное|"
     "многочисленная|многочисленные|многочисленный|мною|мой|мог|могут|можно|может|можхо|"
@@ -270,19 +303,17 @@ std::string Preprocessor::preprocess_stop_words_ru(const std::string& s) const {
     "ту|ты|три|эта|эти|что|это|чтоб|этом|этому|этой|этого|чтобы|этот|стал|туда|этим|"
     "этими|рядом|тринадцать|тринадцатый|этих|третий|тут|эту|суть|чуть|тысяч";
   static const std::regex r{re, std::regex::optimize};
-  return std::regex_replace(s, r, "");
+  return replace(s, r, "");
 }
 
-std::string Preprocessor::preprocess_stop_words(std::string s) const {
-  s = preprocess_stop_words_en(s);
-  s = preprocess_stop_words_ru(s);
-  return s;
+Preprocessor::String Preprocessor::preprocess_stop_words(const String& s) const {
+  return preprocess_stop_words_ru(preprocess_stop_words_en(s));
 }
 
-std::string Preprocessor::preprocess_whitespace(const std::string& s) const {
+Preprocessor::String Preprocessor::preprocess_whitespace(const String& s) const {
   static const auto re1 = "[\t|\n|\r|\a|\b|\f|\v]+";
   static const auto re2 = "^ +| +$|( ) +";
   static const std::regex r1{re1, std::regex::optimize};
   static const std::regex r2{re2, std::regex::optimize};
-  return std::regex_replace(std::regex_replace(s, r1, " "), r2, "$1");
+  return replace(replace(s, r1, " "), r2, "$1");
 }
@@ -2,16 +2,23 @@
 #define PREPROCESSOR_HPP
 
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <memory_resource>
 
 class Preprocessor final {
 public:
   enum class Mode : bool { DEBUG, RELEASE };
 
+  // Every intermediate string of a call is allocated from the resource it is
+  // given, see `Arena`.
+  using String = std::pmr::string;
+
   explicit Preprocessor(const Mode mode = Mode::RELEASE);
   ~Preprocessor();
 
-  std::string preprocess(std::string data) noexcept;
+  String preprocess(std::string_view data,
+                    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) noexcept;
 
 private:
   Mode            _mode;
@@ -21,18 +28,18 @@ private:
 
   bool set_up_file() noexcept;
 
-  void dump(std::string data) noexcept;
-
-  std::string preprocess_email(const std::string& s) const;
-  std::string preprocess_username(const std::string& s) const;
-  std::string preprocess_links(const std::string& s) const;
-  std::string preprocess_emojis_deletion(const std::string& s) const;
-  std::string preprocess_emojis_isolation(const std::string& s) const;
-  std::string preprocess_emojis(std::string s) const;
-  std::string preprocess_stop_words_en(const std::string& s) const;
-  std::string preprocess_stop_words_ru(const std::string& s) const;
-  std::string preprocess_stop_words(std::string s) const;
-  std::string preprocess_whitespace(const std::string& s) const;
+  void dump(std::string_view data) noexcept;
+
+  String preprocess_email(const String& s) const;
+  String preprocess_username(const String& s) const;
+  String preprocess_links(const String& s) const;
+  String preprocess_emojis_deletion(const String& s) const;
+  String preprocess_emojis_isolation(const String& s) const;
+  String preprocess_emojis(const String& s) const;
+  String preprocess_stop_words_en(const String& s) const;
+  String preprocess_stop_words_ru(const String& s) const;
+  String preprocess_stop_words(const String& s) const;
+  String preprocess_whitespace(const String& s) const;
 };
 
 #endif // PREPROCESSOR_HPP
@@ -0,0 +1,116 @@
+// Prunes a category model to the input rows a sample of channels uses.
+//
+// Every line of the sample is the text of one channel (title, description and
+// posts), preprocessed the same way libtgcat does before prediction. The rows
+// used fewer than `min-count` times are dropped, the accuracy of the pruned
+// model is compared on a validation file in the fastText format, whose texts
+// are preprocessed the same way.
+
+#include "preprocessor.hpp"
+
+#include "../../resources/fasttext/src/fasttext.h"
+#include "../../resources/fasttext/src/meter.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace fasttext;
+
+static
+void print_usage() {
+  std::cerr << "usage: tgcat-prune <model> <sample> <validation> <min-count> <output> [dense|quant|int8]\n\n"
+            << "  <model>       dense category model\n"
+            << "  <sample>      channel texts, one per line\n"
+            << "  <validation>  labeled validation file\n"
+            << "  <min-count>   number of uses a row needs to be kept\n"
+            << "  <output>      pruned model filename\n"
+            << "  [storage]     storage of the pruned input vectors [dense]\n"
+            << std::endl;
+}
+
+// Validation file with the text after the leading labels of every line
+// preprocessed.
+static
+std::string read_validation(Preprocessor& pp, const std::string& path) {
+  std::ifstream ifs{path};
+  if (!ifs.is_open()) {
+    throw std::invalid_argument{path + " cannot be opened!"};
+  }
+  std::string validation;
+  for (std::string line; std::getline(ifs, line);) {
+    std::size_t text{0};
+    while (line.compare(text, 9, "__label__") == 0) {
+      text = line.find(' ', text);
+      text = text == std::string::npos ? line.size() : text + 1;
+    }
+    validation.append(line, 0, text);
+    validation += pp.preprocess(std::string_view{line}.substr(text));
+    validation += '\n';
+  }
+  return validation;
+}
+
+static
+double precision_at_one(const FastText& ft, const std::string& validation) {
+  std::istringstream iss{validation};
+  Meter meter{false};
+  ft.test(iss, 1, 0.0, meter);
+  return meter.precision();
+}
+
+int main(int argc, char** argv) {
+  const std::vector<std::string> args(argv, argv + argc);
+  if (args.size() != 6 && args.size() != 7) {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+  const auto storage = args.size() == 7 ? args[6] : "dense";
+  if (storage != "dense" && storage != "quant" && storage != "int8") {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+
+  try {
+    FastText ft;
+    ft.loadModel(args[1]);
+    const auto rows = ft.getInputMatrix()->size(0);
+    Preprocessor pp;
+    const auto validation = read_validation(pp, args[3]);
+    const auto precision = precision_at_one(ft, validation);
+
+    std::ifstream sample{args[2]};
+    if (!sample.is_open()) {
+      throw std::invalid_argument{args[2] + " cannot be opened!"};
+    }
+    std::vector<int64_t> counts;
+    std::size_t channels{0};
+    for (std::string line; std::getline(sample, line); ++channels) {
+      std::istringstream iss{std::string{pp.preprocess(line)} + '\n'};
+      ft.countRows(iss, counts);
+    }
+
+    ft.pruneRows(counts, std::stoll(args[4]));
+    const auto pruned_rows = ft.getInputMatrix()->size(0);
+    if (storage != "dense") {
+      Args qargs;
+      qargs.qint8 = (storage == "int8");
+      ft.quantize(qargs);
+    }
+    const auto pruned_precision = precision_at_one(ft, validation);
+    ft.saveModel(args[5]);
+
+    std::cout << "Channels:  " << channels << '\n'
+              << "Rows:      " << rows << " -> " << pruned_rows << '\n'
+              << "P@1:       " << precision << " -> " << pruned_precision
+              << " (" << std::showpos << pruned_precision - precision
+              << std::noshowpos << ")" << std::endl;
+  } catch (const std::exception& ex) {
+    std::cerr << "Exception: " << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
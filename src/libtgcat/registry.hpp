@@ -0,0 +1,185 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include "lazy_predictor.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Category predictors keyed by language code. Models are loaded on first use
+// and the least recently used ones are evicted once the resident models
+// exceed the memory budget. The footprint of a model is estimated by the size
+// of its file.
+class Registry final {
+public:
+  using Predictor_t = LazyPredictor::Predictor_t;
+
+  struct Stats {
+    std::size_t loads{0};
+    std::size_t evictions{0};
+    std::size_t hits{0};
+    std::size_t memory{0};
+  };
+
+  // `memory_budget` in bytes, 0 means unlimited.
+  explicit Registry(const std::size_t memory_budget) : _memory_budget{memory_budget} {}
+
+  // Registers the model of a language, must not be called concurrently with
+  // other methods.
+  void add(const std::string& code, const std::string& model_path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(model_path, ec);
+    auto entry = std::make_unique<Entry>("Category Predictor (" + code + ")", model_path);
+    entry->footprint = ec ? 0 : static_cast<std::size_t>(size);
+    _order.push_back(code);
+    _entries[code] = std::move(entry);
+  }
+
+  // Whether a model is registered for the language.
+  bool contains(const std::string& code) const noexcept {
+    return _entries.find(code) != _entries.end();
+  }
+
+  // Returns the predictor of the language, loading it if necessary, or
+  // `nullptr` if there is no model for the language or loading failed.
+  Predictor_t get(const std::string& code) noexcept {
+    const auto it = _entries.find(code);
+    if (it == _entries.end()) {
+      return nullptr;
+    }
+    auto& entry = *it->second;
+    entry.last_use = ++_clock;
+    if (auto predictor = entry.model.loaded()) {
+      ++_hits;
+      return predictor;
+    }
+    auto predictor = entry.model.get();
+    if (predictor) {
+      enforce_budget(entry);
+    }
+    return predictor;
+  }
+
+  // Starts loading, on background threads, the models that fit into the
+  // memory budget in registration order.
+  void prefetch() {
+    for (const auto& entry : fitting()) {
+      entry->model.prefetch();
+    }
+  }
+
+  // Loads the models that fit into the memory budget and waits for them.
+  // Rethrows the exception of a failed load.
+  void wait() {
+    const auto entries = fitting();
+    for (const auto& entry : entries) {
+      entry->model.prefetch();
+    }
+    for (const auto& entry : entries) {
+      entry->model.wait();
+    }
+  }
+
+  // Starts reloading every model which is in use, see `LazyPredictor::reload()`.
+  std::vector<std::pair<std::string, std::future<Predictor_t>>> reload() {
+    std::vector<std::pair<std::string, std::future<Predictor_t>>> futures;
+    for (const auto& code : _order) {
+      auto future = _entries.at(code)->model.reload();
+      if (future.valid()) {
+        futures.emplace_back(code, std::move(future));
+      }
+    }
+    return futures;
+  }
+
+  void publish(const std::string& code, Predictor_t predictor) {
+    _entries.at(code)->model.publish(std::move(predictor));
+  }
+
+  // Loaded predictors in registration order.
+  std::vector<Predictor_t> loaded() const {
+    std::vector<Predictor_t> predictors;
+    for (const auto& code : _order) {
+      if (auto predictor = _entries.at(code)->model.loaded()) {
+        predictors.push_back(std::move(predictor));
+      }
+    }
+    return predictors;
+  }
+
+  Stats stats() const noexcept {
+    Stats stats;
+    stats.evictions = _evictions;
+    stats.hits = _hits;
+    for (const auto& [_, entry] : _entries) {
+      stats.loads += entry->model.loads();
+      if (entry->model.loaded()) {
+        stats.memory += entry->footprint;
+      }
+    }
+    return stats;
+  }
+
+private:
+  struct Entry {
+    Entry(std::string name, std::string model_path)
+      : model{std::move(name), std::move(model_path)} {}
+
+    LazyPredictor               model;
+    std::size_t                 footprint{0};
+    std::atomic<std::uint64_t>  last_use{0};
+  };
+
+  const std::size_t                                       _memory_budget;
+  std::unordered_map<std::string, std::unique_ptr<Entry>> _entries;
+  std::vector<std::string>                                _order;
+  std::atomic<std::uint64_t>                              _clock{0};
+  std::atomic<std::size_t>                                _hits{0};
+  std::atomic<std::size_t>                                _evictions{0};
+  std::mutex                                              _eviction_mutex;
+
+  std::vector<Entry *> fitting() const {
+    std::vector<Entry *> entries;
+    std::size_t memory{0};
+    for (const auto& code : _order) {
+      const auto& entry = _entries.at(code);
+      if (_memory_budget == 0 || memory + entry->footprint <= _memory_budget) {
+        memory += entry->footprint;
+        entries.push_back(entry.get());
+      }
+    }
+    return entries;
+  }
+
+  // Evicts least recently used models, except `keep`, while the resident
+  // models exceed the budget.
+  void enforce_budget(const Entry& keep) {
+    if (_memory_budget == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock{_eviction_mutex};
+    while (stats().memory > _memory_budget) {
+      Entry *victim{nullptr};
+      for (const auto& [_, entry] : _entries) {
+        if (entry.get() != &keep && entry->model.loaded() &&
+            (victim == nullptr || entry->last_use < victim->last_use)) {
+          victim = entry.get();
+        }
+      }
+      if (victim == nullptr) {
+        break;
+      }
+      victim->model.evict();
+      ++_evictions;
+    }
+  }
+};
+
+#endif // REGISTRY_HPP
@@ -0,0 +1,217 @@
+#ifndef SCRIPT_HPP
+#define SCRIPT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Histogram of the letters of a text by Unicode script, used to name the
+// language of texts written in a script of a single language without running
+// the language model. Letters of other scripts, such as links and usernames
+// in Latin, are tolerated up to a share.
+class ScriptHistogram final {
+public:
+  // Adds the letters of a null-terminated UTF-8 string. Runs of ASCII are
+  // counted 8 bytes at a time.
+  void add(const char *text) noexcept {
+    const auto *s = reinterpret_cast<const unsigned char *>(text);
+    const auto *end = s + std::strlen(text);
+    while (s != end) {
+      if (end - s >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, s, sizeof(word));
+        if ((word & 0x8080808080808080ULL) == 0) {
+          _letters[Latin] += ascii_letters(word);
+          s += 8;
+          continue;
+        }
+      }
+      s = add_codepoint(s, end);
+    }
+  }
+
+  std::size_t letters() const noexcept {
+    std::size_t total{0};
+    for (const auto count : _letters) {
+      total += count;
+    }
+    return total;
+  }
+
+  // Number of counters the histogram is made of, see `save()`.
+  static constexpr std::size_t size() noexcept { return Count + 2; }
+
+  // Copies the `size()` counters of the histogram to `counters`, from which
+  // `load()` restores it.
+  void save(std::uint64_t *counters) const noexcept {
+    for (std::size_t i{0}; i != Count; ++i) {
+      counters[i] = _letters[i];
+    }
+    counters[Count] = _russian_markers;
+    counters[Count + 1] = _non_russian;
+  }
+  void load(const std::uint64_t *counters) noexcept {
+    for (std::size_t i{0}; i != Count; ++i) {
+      _letters[i] = counters[i];
+    }
+    _russian_markers = counters[Count];
+    _non_russian = counters[Count + 1];
+  }
+
+  // Language code if at least `min_letters` letters were added, `min_share` of
+  // them in one script that names the language; `nullptr` otherwise.
+  // Cyrillic is taken as Russian only with `ы` or `э` and without letters
+  // other Cyrillic alphabets add.
+  const char *language(const std::size_t min_letters, const double min_share) const noexcept {
+    const auto total = letters();
+    if (total == 0 || total < min_letters) {
+      return nullptr;
+    }
+    const auto cjk = _letters[Kana] + _letters[Han];
+    if (cjk >= min_share * total) {
+      // kana make up a large part of any Japanese text, Chinese is left to
+      // the model
+      return (_letters[Kana] * 5 >= cjk) ? "ja" : nullptr;
+    }
+    std::size_t script{0};
+    for (std::size_t i{1}; i != Count; ++i) {
+      if (_letters[i] > _letters[script]) {
+        script = i;
+      }
+    }
+    if (_letters[script] < min_share * total) {
+      return nullptr;
+    }
+    if (script == Cyrillic) {
+      return (_russian_markers != 0 && _non_russian == 0) ? "ru" : nullptr;
+    }
+    return CODES[script];
+  }
+
+private:
+  enum Script : std::uint8_t {
+    Latin, Cyrillic, Greek, Armenian, Hebrew, Arabic, Devanagari, Bengali,
+    Gurmukhi, Gujarati, Tamil, Telugu, Kannada, Malayalam, Sinhala, Thai,
+    Lao, Tibetan, Myanmar, Georgian, Hangul, Ethiopic, Khmer, Kana, Han,
+    Count, None = Count
+  };
+
+  // code of the language a script is specific to, `nullptr` if it is shared
+  static constexpr const char *CODES[Count] = {
+    nullptr, nullptr, "el", "hy", nullptr, nullptr, nullptr, nullptr,
+    "pa", "gu", "ta", "te", "kn", "ml", "si", "th",
+    "lo", nullptr, "my", "ka", "ko", nullptr, "km", nullptr, nullptr,
+  };
+
+  struct Range {
+    char32_t first;
+    char32_t last;
+    Script   script;
+  };
+
+  // letter blocks of the scripts, sorted
+  static constexpr Range RANGES[] = {
+    {0x00C0, 0x00D6, Latin},      {0x00D8, 0x00F6, Latin},
+    {0x00F8, 0x024F, Latin},      {0x0370, 0x03FF, Greek},
+    {0x0400, 0x052F, Cyrillic},   {0x0531, 0x058F, Armenian},
+    {0x05D0, 0x05F4, Hebrew},     {0x0620, 0x06FF, Arabic},
+    {0x0900, 0x097F, Devanagari}, {0x0980, 0x09FF, Bengali},
+    {0x0A00, 0x0A7F, Gurmukhi},   {0x0A80, 0x0AFF, Gujarati},
+    {0x0B80, 0x0BFF, Tamil},      {0x0C00, 0x0C7F, Telugu},
+    {0x0C80, 0x0CFF, Kannada},    {0x0D00, 0x0D7F, Malayalam},
+    {0x0D80, 0x0DFF, Sinhala},    {0x0E00, 0x0E7F, Thai},
+    {0x0E80, 0x0EFF, Lao},        {0x0F00, 0x0FFF, Tibetan},
+    {0x1000, 0x109F, Myanmar},    {0x10A0, 0x10FF, Georgian},
+    {0x1100, 0x11FF, Hangul},     {0x1200, 0x139F, Ethiopic},
+    {0x1780, 0x17FF, Khmer},      {0x1E00, 0x1EFF, Latin},
+    {0x3040, 0x30FF, Kana},       {0x3400, 0x4DBF, Han},
+    {0x4E00, 0x9FFF, Han},        {0xAC00, 0xD7AF, Hangul},
+  };
+
+  std::array<std::size_t, Count> _letters{};
+  std::size_t _russian_markers{0};
+  std::size_t _non_russian{0};
+
+  // number of ASCII letters in 8 ASCII bytes
+  static int ascii_letters(const std::uint64_t word) noexcept {
+    constexpr auto ones = 0x0101010101010101ULL;
+    constexpr auto highs = 0x8080808080808080ULL;
+    const auto lower = word | (0x20 * ones);
+    const auto from_a = (lower + (0x80 - 'a') * ones) & highs;
+    const auto past_z = (lower + (0x80 - 'z' - 1) * ones) & highs;
+    return __builtin_popcountll(from_a & ~past_z);
+  }
+
+  static Script script_of(const char32_t cp) noexcept {
+    std::size_t lo{0};
+    std::size_t hi{sizeof(RANGES) / sizeof(RANGES[0])};
+    while (lo != hi) {
+      const auto mid = (lo + hi) / 2;
+      if (RANGES[mid].last < cp) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return (lo != sizeof(RANGES) / sizeof(RANGES[0]) && RANGES[lo].first <= cp)
+               ? RANGES[lo].script
+               : None;
+  }
+
+  // Decodes one character, returns the position after it. Invalid bytes are
+  // skipped one at a time.
+  const unsigned char *add_codepoint(const unsigned char *s, const unsigned char *end) noexcept {
+    const auto lead = *s;
+    if (lead < 0x80) {
+      if ((lead | 0x20) >= 'a' && (lead | 0x20) <= 'z') {
+        ++_letters[Latin];
+      }
+      return s + 1;
+    }
+    std::size_t length;
+    char32_t cp;
+    if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      cp = lead & 0x07;
+    } else {
+      return s + 1;
+    }
+    if (static_cast<std::size_t>(end - s) < length) {
+      return end;
+    }
+    for (std::size_t i{1}; i != length; ++i) {
+      if ((s[i] & 0xC0) != 0x80) {
+        return s + 1;
+      }
+      cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    const auto script = script_of(cp);
+    if (script != None) {
+      ++_letters[script];
+      if (script == Cyrillic) {
+        add_cyrillic(cp);
+      }
+    }
+    return s + length;
+  }
+
+  void add_cyrillic(const char32_t cp) noexcept {
+    // ы Ы э Э
+    if (cp == 0x044B || cp == 0x042B || cp == 0x044D || cp == 0x042D) {
+      ++_russian_markers;
+    }
+    // letters beyond а-я А-Я ё Ё, e.g. і ї є ў ј љ ң ө
+    if ((cp < 0x0410 || cp > 0x044F) && cp != 0x0401 && cp != 0x0451) {
+      ++_non_russian;
+    }
+  }
+};
+
+#endif // SCRIPT_HPP
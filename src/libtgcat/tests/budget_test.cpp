@@ -0,0 +1,92 @@
+#include "check.hpp"
+#include "../budget.hpp"
+
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t total(const Posts& posts, const std::size_t used) {
+  auto bytes = used;
+  for (const auto post : posts) {
+    bytes += post.size() + 1;
+  }
+  return bytes;
+}
+
+void test_utf8_prefix() {
+  const char *text = "ab\xD0\xBF\xD1\x80";  // ab + 2 two-byte letters
+  check(utf8_prefix(text, 6) == 6, "a whole string is kept");
+  check(utf8_prefix(text, 4) == 4, "a prefix ending between letters is kept");
+  check(utf8_prefix(text, 3) == 2, "a prefix does not end within a letter");
+  check(utf8_prefix(text, 0) == 0, "an empty prefix is kept");
+}
+
+void test_unlimited() {
+  std::pmr::monotonic_buffer_resource resource;
+  const char *posts[] = {"first", "second", "third"};
+  const auto all = select_posts(100, posts, 3, 0, 16, &resource);
+  check(all.size() == 3 && all[1] == "second", "a budget of 0 keeps every post");
+  const auto fit = select_posts(10, posts, 3, 10 + 6 + 7 + 6, 16, &resource);
+  check(fit.size() == 3 && fit[2] == "third", "posts within the budget are kept whole");
+  const auto none = select_posts(100, posts, 3, 100, 16, &resource);
+  check(none.empty(), "no post is kept when title and description fill the budget");
+}
+
+void test_over_budget() {
+  std::pmr::monotonic_buffer_resource resource;
+  std::vector<std::string> texts;
+  for (int i{0}; i != 20; ++i) {
+    texts.push_back(std::string(i % 2 ? 300 : 20, 'a' + i));
+  }
+  std::vector<const char *> posts;
+  for (const auto& text : texts) {
+    posts.push_back(text.c_str());
+  }
+
+  const std::size_t used{100};
+  const std::size_t budget{1100};
+  const auto selected = select_posts(used, posts.data(), posts.size(), budget, 100, &resource);
+  check(!selected.empty() && selected.size() <= (budget - used) / 101,
+        "as many posts as fit with the minimum bytes are kept");
+  check(total(selected, used) <= budget, "the selected posts fit into the budget");
+  check(selected.front().data() == posts.front() && selected.back().data() != posts.back(),
+        "the kept posts are spread over the channel");
+  bool short_whole{true};
+  for (const auto post : selected) {
+    if (post.front() % 2 == 'a' % 2 && post.size() != 20) {
+      short_whole = false;
+    }
+  }
+  check(short_whole, "posts shorter than their share are kept whole");
+}
+
+void test_truncated_utf8() {
+  std::pmr::monotonic_buffer_resource resource;
+  std::string text;
+  for (int i{0}; i != 200; ++i) {
+    text += "\xD0\xBF";
+  }
+  const char *posts[] = {text.c_str(), text.c_str()};
+  const auto selected = select_posts(0, posts, 2, 201, 50, &resource);
+  check(selected.size() == 2, "two posts are kept");
+  bool whole_letters{true};
+  for (const auto post : selected) {
+    if (post.size() % 2 != 0 || post.size() > 99) {
+      whole_letters = false;
+    }
+  }
+  check(whole_letters, "truncated posts keep whole letters within their share");
+}
+
+} // namespace
+
+int main() {
+  test_utf8_prefix();
+  test_unlimited();
+  test_over_budget();
+  test_truncated_utf8();
+  return exit_code("budget_test");
+}
@@ -0,0 +1,88 @@
+#include "check.hpp"
+#include "../channel.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+TgcatChannel make_channel() {
+  TgcatChannel channel;
+  channel.script.add("Новости канала, links: https://t.me/example");
+  channel.posts = 3;
+  channel.sums.push_back({{}, 0x1234, 17, {0.5f, -1.25f, 2.0f}, {}});
+  channel.sums.push_back({"ru", 0x5678, 42, {1.0f, 0.0f, -0.5f, 3.5f}, {-7, 123456}});
+  return channel;
+}
+
+std::vector<unsigned char> serialize(const TgcatChannel& channel) {
+  std::vector<unsigned char> blob(channel.serialized_size());
+  channel.serialize(blob.data());
+  return blob;
+}
+
+void test_round_trip() {
+  const auto channel = make_channel();
+  const auto blob = serialize(channel);
+  const auto restored = TgcatChannel::deserialize(blob.data(), blob.size());
+  check(restored != nullptr, "round trip is deserialized");
+  if (!restored) {
+    return;
+  }
+  check(restored->posts == channel.posts, "round trip keeps posts");
+  check(restored->script.letters() == channel.script.letters(), "round trip keeps the script");
+  check(restored->sums.size() == channel.sums.size(), "round trip keeps the sums");
+  for (std::size_t i{0}; i != channel.sums.size() && i != restored->sums.size(); ++i) {
+    const auto& a = channel.sums[i];
+    const auto& b = restored->sums[i];
+    check(a.code == b.code && a.fingerprint == b.fingerprint && a.count == b.count &&
+          a.sum == b.sum && a.window == b.window, "round trip keeps a sum");
+  }
+  check(serialize(*restored) == blob, "round trip serializes to the same bytes");
+}
+
+void test_malformed() {
+  const auto blob = serialize(make_channel());
+  for (std::size_t size{0}; size != blob.size(); ++size) {
+    if (TgcatChannel::deserialize(blob.data(), size)) {
+      check(false, "truncated blob is rejected");
+      break;
+    }
+  }
+
+  auto longer = blob;
+  longer.push_back(0);
+  check(!TgcatChannel::deserialize(longer.data(), longer.size()), "trailing byte is rejected");
+
+  auto magic = blob;
+  magic[0] ^= 0xff;
+  check(!TgcatChannel::deserialize(magic.data(), magic.size()), "bad magic is rejected");
+
+  TgcatChannel empty;
+  const auto no_sums = serialize(empty);
+  check(!TgcatChannel::deserialize(no_sums.data(), no_sums.size()), "channel without sums is rejected");
+
+  auto category_first = make_channel();
+  std::swap(category_first.sums[0], category_first.sums[1]);
+  const auto swapped = serialize(category_first);
+  check(!TgcatChannel::deserialize(swapped.data(), swapped.size()),
+        "channel without the language sum first is rejected");
+
+  // a sum count past the end of the blob
+  auto count = blob;
+  const auto offset = sizeof(std::uint32_t) + sizeof(std::uint64_t) +
+                      ScriptHistogram::size() * sizeof(std::uint64_t);
+  const std::uint32_t huge{0xffffffff};
+  std::memcpy(count.data() + offset, &huge, sizeof(huge));
+  check(!TgcatChannel::deserialize(count.data(), count.size()), "bad sum count is rejected");
+}
+
+} // namespace
+
+int main() {
+  test_round_trip();
+  test_malformed();
+  return exit_code("channel_test");
+}
@@ -0,0 +1,28 @@
+#ifndef TESTS_CHECK_HPP
+#define TESTS_CHECK_HPP
+
+#include <cstdlib>
+#include <iostream>
+
+// Failed checks of a test, which exits with `exit_code()`.
+inline int& failures() noexcept {
+  static int failures{0};
+  return failures;
+}
+
+inline void check(const bool condition, const char *what) {
+  if (!condition) {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++failures();
+  }
+}
+
+inline int exit_code(const char *test) {
+  if (failures() != 0) {
+    return EXIT_FAILURE;
+  }
+  std::cout << test << ": OK" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#endif // TESTS_CHECK_HPP
@@ -0,0 +1,103 @@
+#include "check.hpp"
+#include "../lru_cache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// keys of one shard, which the high bits pick
+constexpr std::uint64_t key(const std::uint64_t i) noexcept { return i; }
+
+bool has(LruCache<int>& cache, const std::uint64_t k, int *value = nullptr) {
+  return cache.find(k, [value](const int v) { if (value) { *value = v; } });
+}
+
+void test_eviction() {
+  LruCache<int> cache{3, 1};
+  cache.insert(key(1), 10);
+  cache.insert(key(2), 20);
+  cache.insert(key(3), 30);
+  check(has(cache, key(1)), "a value is found");
+  cache.insert(key(4), 40);  // evicts 2, the least recently used
+  check(!has(cache, key(2)), "the least recently used value is evicted");
+  check(has(cache, key(1)) && has(cache, key(3)) && has(cache, key(4)),
+        "the other values are kept");
+
+  int value{0};
+  cache.insert(key(3), 33);
+  check(has(cache, key(3), &value) && value == 33, "a value is replaced");
+  check(cache.stats().size == 3, "a replaced value is counted once");
+}
+
+void test_disabled() {
+  LruCache<int> cache{0};
+  cache.insert(key(1), 10);
+  check(!has(cache, key(1)), "a cache of capacity 0 keeps nothing");
+  const auto stats = cache.stats();
+  check(stats.size == 0 && stats.memory == 0 && stats.misses == 1,
+        "a cache of capacity 0 counts misses");
+}
+
+void test_stats() {
+  LruCache<int> cache{4, 2};
+  for (std::uint64_t i{0}; i != 4; ++i) {
+    cache.insert(i << 32, static_cast<int>(i));
+  }
+  has(cache, 0);
+  has(cache, 5);
+  auto stats = cache.stats();
+  check(stats.hits == 1 && stats.misses == 1, "hits and misses are counted");
+  check(stats.size == 4 && stats.memory != 0, "size and memory are estimated");
+  cache.clear();
+  stats = cache.stats();
+  check(stats.size == 0 && stats.memory == 0, "clear drops every value");
+  check(stats.hits == 1 && stats.misses == 1, "clear keeps the counters");
+}
+
+void test_ttl() {
+  LruCache<int> cache{4, 1, std::chrono::milliseconds{20}};
+  cache.insert(key(1), 10);
+  check(has(cache, key(1)), "a value is found before it expires");
+  std::this_thread::sleep_for(std::chrono::milliseconds{40});
+  check(!has(cache, key(1)), "an expired value is not found");
+  check(cache.stats().size == 0, "an expired value is dropped");
+}
+
+void test_threads() {
+  LruCache<int> cache{64};
+  std::atomic<int> mixed{0};
+  std::vector<std::thread> threads;
+  for (int t{0}; t != 4; ++t) {
+    threads.emplace_back([&cache, &mixed] {
+      for (std::uint64_t i{0}; i != 1000; ++i) {
+        const auto k = (i % 100) * 0x9E3779B97F4A7C15ULL;
+        int value{0};
+        if (!has(cache, k, &value)) {
+          cache.insert(k, static_cast<int>(i % 100));
+        } else if (value != static_cast<int>(i % 100)) {
+          ++mixed;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  check(mixed == 0, "values are not mixed up across threads");
+  check(cache.stats().size <= 64, "the capacity holds across threads");
+}
+
+} // namespace
+
+int main() {
+  test_eviction();
+  test_disabled();
+  test_stats();
+  test_ttl();
+  test_threads();
+  return exit_code("lru_cache_test");
+}
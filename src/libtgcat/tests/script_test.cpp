@@ -0,0 +1,67 @@
+#include "check.hpp"
+#include "../script.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+const char *language_of(const char *text, const std::size_t min_letters = 16,
+                        const double min_share = 0.7) {
+  ScriptHistogram histogram;
+  histogram.add(text);
+  return histogram.language(min_letters, min_share);
+}
+
+bool is(const char *code, const char *expected) {
+  return code != nullptr && std::strcmp(code, expected) == 0;
+}
+
+void test_letters() {
+  ScriptHistogram histogram;
+  histogram.add("Hello, world! 123 https://t.me");
+  check(histogram.letters() == 18, "ASCII letters are counted, digits and marks are not");
+  histogram.add("\xD0\xBF\xD1\x80\xD0\xB8");  // при
+  check(histogram.letters() == 21, "Cyrillic letters are counted");
+  histogram.add("\xFF\xD0");
+  check(histogram.letters() == 21, "invalid and truncated bytes are skipped");
+}
+
+void test_languages() {
+  check(is(language_of("Это новости нашего канала, подписывайтесь"), "ru"),
+        "Russian is named from ы and э");
+  check(language_of("Новини нашого каналу, підписуйтесь і читайте") == nullptr,
+        "Cyrillic with і is left to the model");
+  check(language_of("Новости канала про спорт и погоду") == nullptr,
+        "Cyrillic without a Russian marker is left to the model");
+  check(is(language_of("Καλημέρα σε όλους τους αναγνώστες μας"), "el"), "Greek is named");
+  check(is(language_of("สวัสดีครับ ยินดีต้อนรับสู่ช่องของเรา"), "th"), "Thai is named");
+  check(is(language_of("今日はとても良い天気ですね、みなさん"), "ja"), "kana name Japanese");
+  check(language_of("今天天气很好我们一起去公园散步吧朋友们") == nullptr,
+        "Han without kana is left to the model");
+  check(language_of("Breaking news from our channel today") == nullptr,
+        "Latin is left to the model");
+  check(language_of("Καλημέρα") == nullptr, "too few letters are left to the model");
+  check(language_of("Καλημέρα σε όλους, read more at https://example.com/news") == nullptr,
+        "mixed scripts below the share are left to the model");
+}
+
+void test_save_load() {
+  ScriptHistogram histogram;
+  histogram.add("Это новости нашего канала, подписывайтесь");
+  std::uint64_t counters[ScriptHistogram::size()];
+  histogram.save(counters);
+  ScriptHistogram loaded;
+  loaded.load(counters);
+  check(loaded.letters() == histogram.letters(), "a loaded histogram keeps its letters");
+  check(is(loaded.language(16, 0.7), "ru"), "a loaded histogram keeps its markers");
+}
+
+} // namespace
+
+int main() {
+  test_letters();
+  test_languages();
+  test_save_load();
+  return exit_code("script_test");
+}
@@ -1,35 +1,182 @@
 #ifndef TG_HPP
 #define TG_HPP
 
+#include "tgcat.hpp"
 #include "config.hpp"
 #include "cache.hpp"
 #include "preprocessor.hpp"
 #include "predictor.hpp"
+#include "registry.hpp"
+#include "lru_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
 #include <memory>
+#include <mutex>
 
 struct tgcat_manager_s {
   using Preprocessor_t = std::unique_ptr<Preprocessor>;
-  using Predictor_t = std::unique_ptr<Predictor>;
+  using Predictor_t = std::shared_ptr<Predictor>;
+
+  // Language and category distribution of a channel.
+  struct Result {
+    char    language_code[6];
+    double  category_probability[TGCAT_CATEGORY_OTHER + 1];
+  };
+
+  // Channel between the language and the category detection of the calling
+  // thread: its key in the result cache, and its result if it was found there.
+  struct Pending {
+    std::uint64_t key{0};
+    bool          valid{false};
+    bool          found{false};
+    Result        result;
+  };
 
-  Cache           cache;
   Preprocessor_t  pp{nullptr};
   Predictor_t     lp{nullptr};
-  Predictor_t     cp_en{nullptr};
-  Predictor_t     cp_ru{nullptr};
+  Registry        cp{Config::Registry::memory_budget};
+  LruCache<Result> results{Config::ResultCache::capacity, Config::ResultCache::shards,
+                           std::chrono::seconds{Config::ResultCache::ttl_seconds}};
+  // bumped by every reload, part of the result cache keys
+  std::atomic<std::uint64_t> generation{0};
+
+  // language requests, those decided by the script of the channel, and
+  // passes and early stops of the randomized language detection
+  std::atomic<std::size_t> language_requests{0};
+  std::atomic<std::size_t> language_script_hits{0};
+  std::atomic<std::size_t> language_passes{0};
+  std::atomic<std::size_t> language_early_stops{0};
+
+  tgcat_manager_s() {
+    for (const auto& category : Config::Language::Model::categories) {
+      cp.add(category.code, category.path);
+    }
+  }
+
+  // Post cache statistics summed over the language predictor and the loaded
+  // category predictors.
+  Predictor::PostCache::Stats post_cache_stats() const {
+    Predictor::PostCache::Stats total;
+    auto predictors = cp.loaded();
+    if (auto predictor = language_predictor()) {
+      predictors.push_back(std::move(predictor));
+    }
+    for (const auto& predictor : predictors) {
+      const auto stats = predictor->post_cache_stats();
+      total.hits += stats.hits;
+      total.misses += stats.misses;
+      total.size += stats.size;
+    }
+    return total;
+  }
+
+  // Language detection state of the calling thread, reused by its category
+  // detection.
+  static Cache& cache() noexcept {
+    thread_local Cache cache;
+    return cache;
+  }
 
-  int init() noexcept {
+  static Pending& pending() noexcept {
+    thread_local Pending pending;
+    return pending;
+  }
+
+  // Snapshot of the current language predictor, see `reload()`.
+  Predictor_t language_predictor() const noexcept { return std::atomic_load(&lp); }
+
+  int init(const TgcatModelLoading loading) noexcept {
     using namespace Config::Language;
+    const auto start = std::chrono::steady_clock::now();
     try {
+      // models are independent, load them concurrently;
+      // `get()` and `wait()` rethrow the exception of a failed load
+      auto lp_future = load_async("Language Predictor", Model::language);
+      if (loading == TGCAT_MODEL_LOADING_EAGER) {
+        cp.prefetch();
+      }
       pp = std::make_unique<Preprocessor>(Preprocessor::Mode::RELEASE);
-      lp = std::make_unique<Predictor>("Language Predictor", Model::language);
-      cp_en = std::make_unique<Predictor>("Category Predictor (en)", Model::category_en);
-      cp_ru = std::make_unique<Predictor>("Category Predictor (ru)", Model::category_ru);
+      std::atomic_store(&lp, lp_future.get());
+      if (loading == TGCAT_MODEL_LOADING_EAGER) {
+        cp.wait();
+      } else if (loading == TGCAT_MODEL_LOADING_BACKGROUND) {
+        cp.prefetch();
+      }
     } catch (const std::exception& ex) {
       std::cerr << "ERROR: Initialization failed!" << std::endl;
       return -1;
     }
+    if (Config::Startup::report) {
+      report(utils::getDuration(start, std::chrono::steady_clock::now()), loading);
+    }
+    return 0;
+  }
+
+  // Loads fresh instances of the language model and of every category model
+  // that has been requested so far, then publishes them. Nothing is published
+  // if any of them fails to load. Requests are served by the previous
+  // instances in the meantime, and requests in flight finish on them.
+  int reload() noexcept {
+    using namespace Config::Language;
+    std::lock_guard<std::mutex> lock{_reload_mutex};
+    try {
+      auto lp_future = load_async("Language Predictor", Model::language);
+      auto cp_futures = cp.reload();
+      auto new_lp = lp_future.get();
+      std::vector<std::pair<std::string, Predictor_t>> new_cps;
+      for (auto& [code, future] : cp_futures) {
+        new_cps.emplace_back(code, future.get());
+      }
+      std::atomic_store(&lp, new_lp);
+      for (auto& [code, predictor] : new_cps) {
+        cp.publish(code, std::move(predictor));
+      }
+      // results of the previous models are stale, and those of requests still
+      // in flight on them are inserted under keys of the previous generation
+      ++generation;
+      results.clear();
+    } catch (const std::exception& ex) {
+      std::cerr << "ERROR: Reloading models failed!" << std::endl;
+      return -1;
+    }
     return 0;
   }
+
+private:
+  std::mutex _reload_mutex;
+
+  static std::future<Predictor_t> load_async(const char *name, const char *path) {
+    return std::async(std::launch::async, [name, path] {
+      return std::make_shared<Predictor>(name, path);
+    });
+  }
+
+  static void report(const Predictor& p) {
+    const auto& profile = p.load_profile();
+    std::cerr << "Startup | " << p.name() << ": " << p.load_time() << "s"
+              << " (args " << profile.args << "s"
+              << ", dictionary " << profile.dictionary << "s"
+              << ", input " << profile.input << "s"
+              << ", output " << profile.output << "s)" << std::endl;
+  }
+
+  void report(const double total, const TgcatModelLoading loading) {
+    const auto flags = std::cerr.flags();
+    const auto precision = std::cerr.precision();
+    std::cerr << std::fixed << std::setprecision(3)
+              << "Startup | " << total << "s total" << std::endl;
+    report(*lp);
+    if (loading == TGCAT_MODEL_LOADING_EAGER) {
+      for (const auto& predictor : cp.loaded()) {
+        report(*predictor);
+      }
+    }
+    std::cerr.flags(flags);
+    std::cerr.precision(precision);
+  }
 };
 
 #endif // TG_HPP
@@ -1,50 +1,48 @@
 #include "tgcat.hpp"
 
+#include "arena.hpp"
+#include "budget.hpp"
+#include "channel.hpp"
+#include "hash.hpp"
+#include "script.hpp"
 #include "tg.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <memory_resource>
+#include <set>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 #include <utility>
 
 // global instances (not exported)
 static tgcat_manager_s tg;
 
-// definitions
+// temporaries of a request are allocated from the arena of the thread
+using String = Preprocessor::String;
 
-static
-std::string get_valid_language_code(std::string code) noexcept {
-  code = code.substr(9); // skip __label___
-  // support only 2-letter language codes
-  // `sh` is not in the Wikipedia ISO 639-1 list so it is not considered
-  return ((code.length() == 2 && code != "sh") ? code : "other");
-}
+// definitions
 
+// Title and description separated by a space, kept whole whatever the budget.
 static
-std::vector<std::pair<real, std::string>> get_category_predictions() noexcept {
-  using namespace Config::Language;
-  if (tg.cache.get_code() == Code::English) {
-    return tg.cp_en->predict(tg.cache.get_data(), -1);
-  }
-  if (tg.cache.get_code() == Code::Russian) {
-    return tg.cp_ru->predict(tg.cache.get_data(), -1);
-  }
-  return {};
+String get_channel_head(const TelegramChannelInfo *channel_info,
+                        std::pmr::memory_resource *resource) {
+  String data{channel_info->title, resource};
+  data += ' ';
+  data += channel_info->description;
+  return data;
 }
 
+// Appends the posts separated by spaces, see `select_posts()`.
 static
-void populate_category_probabilites(const std::vector<std::pair<real, std::string>>& predictions,
-                                    double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
-  auto sum = 0.0f;
-  for (const auto& [probability, _] : predictions) {
-    sum += probability;
-  }
-
-  for (auto [probability, label] : predictions) {
-    probability /= sum;
-    label = label.substr(9); // skip __label__
-    const auto index = std::stoi(label);
-    category_probability[index] = probability;
+void append_posts(String& data, const char **posts, const std::size_t count) {
+  const auto selected = select_posts(data.size(), posts, count, Config::Budget::channel_bytes,
+                                     Config::Budget::min_post_bytes, data.get_allocator().resource());
+  for (const auto post : selected) {
+    data += ' ';
+    data += post;
   }
 }
 
@@ -54,10 +52,13 @@ void detect_category(const TelegramChannelInfo *channel_info,
   (void)channel_info;
   memset(category_probability, 0, sizeof(double) * (TGCAT_CATEGORY_OTHER + 1));
 
-  const auto predictions = get_category_predictions();
-  if (!predictions.empty()) {
-    populate_category_probabilites(predictions, category_probability);
-    tg.cache.reset();
+  const auto cp = tg.cp.get(tg.cache().get_code());
+  if (!cp) {
+    return;
+  }
+  if (cp->predict_distribution(tg.cache().get_data(), category_probability,
+                               TGCAT_CATEGORY_OTHER + 1)) {
+    tg.cache().reset();
   }
 }
 
@@ -68,24 +69,23 @@ void detect_category(const TelegramChannelInfo *channel_info,
 namespace UseCase__Complete {
 
 static
-std::string get_channel_data(const TelegramChannelInfo *channel_info,
-                             const bool is_unique = false) noexcept {
-  auto data = std::string{channel_info->title};
-  data += ' ' + std::string{channel_info->description};
+String get_channel_data(const TelegramChannelInfo *channel_info,
+                        const bool is_unique = false) noexcept {
+  const auto resource = Arena::local().resource();
+  auto data = get_channel_head(channel_info, resource);
   const auto count = channel_info->post_count;
   const auto posts = channel_info->posts;
   if (is_unique) {
-    std::set<std::string> unique_posts;
+    std::pmr::set<std::string_view> unique_posts{resource};
     for (std::size_t i = 0; i != count; ++i) {
       unique_posts.emplace(posts[i]);
     }
     for (const auto post : unique_posts) {
-      data += ' ' + post;
+      data += ' ';
+      data += post;
     }
   } else {
-    for (std::size_t i = 0; i != count; ++i) {
-      data += ' ' + std::string{posts[i]};
-    }
+    append_posts(data, posts, count);
   }
   return data;
 }
@@ -94,105 +94,553 @@ static
 void detect_language(const TelegramChannelInfo *channel_info,
                      char language_code[6]) {
   const auto data = get_channel_data(channel_info);
-  const auto preprocessed_data = tg.pp->preprocess(data);
-  const auto predictions = tg.lp->predict(preprocessed_data);
+  const auto preprocessed_data = tg.pp->preprocess(data, data.get_allocator().resource());
+  const auto lp = tg.language_predictor();
+  const auto predictions = lp->predict(preprocessed_data);
   if (predictions.empty()) {
-    tg.cache.reset();
+    tg.cache().reset();
     return;
   }
 
   const auto [_, label] = predictions.at(0);
-  const auto code = get_valid_language_code(label);
+  const auto& code = lp->language_code(label);
   memcpy(language_code, code.c_str(), code.size());
-  tg.cache.set(preprocessed_data, code);
+  tg.cache().set(preprocessed_data, code);
 }
 
 } // UseCase__Complete
 
+// ---- Embedded ----
+
+// The channel is embedded one post at a time, and the sums of the posts a
+// model has seen before, such as reposts and ads, are taken from its post
+// cache. Posts are not sampled, so a single pass gives the result of the
+// randomized voting.
+namespace UseCase__Embedded {
+
+// Preprocessed title and description of the channel, recorded for the
+// category detection.
+static
+void record_head(const TelegramChannelInfo *channel_info, const std::string_view code) {
+  const auto resource = Arena::local().resource();
+  tg.cache().reset();
+  tg.cache().set(tg.pp->preprocess(get_channel_head(channel_info, resource), resource), code);
+}
+
+// Adds the input rows of the channel for `p` to `sum`, returns their number.
+// The preprocessed texts are recorded when `record` is set, for the category
+// detection to reuse them.
+static
+int64_t embed(Predictor& p, const TelegramChannelInfo *channel_info, Vector& sum,
+              const bool record) {
+  const auto resource = Arena::local().resource();
+  const auto head = get_channel_head(channel_info, resource);
+  int64_t count{0};
+  if (record) {
+    const auto preprocessed_head = tg.pp->preprocess(head, resource);
+    tg.cache().reset();
+    tg.cache().set_data(preprocessed_head);
+    count += p.embed(preprocessed_head, sum);
+  } else {
+    count += p.embed(tg.cache().get_data(), sum);
+  }
+
+  const auto posts = select_posts(head.size(), channel_info->posts, channel_info->post_count,
+                                  Config::Budget::channel_bytes, Config::Budget::min_post_bytes,
+                                  resource);
+  for (std::size_t i = 0; i != posts.size(); ++i) {
+    const auto key = hash_bytes(posts[i]);
+    if (const auto cached = p.add_cached_post(key, sum); cached >= 0) {
+      count += cached;
+      if (record) {
+        tg.cache().add_post(key);
+      }
+    } else if (const auto preprocessed = tg.cache().get_post(i, key)) {
+      count += p.add_post(key, *preprocessed, sum);
+    } else {
+      const auto preprocessed_post = tg.pp->preprocess(posts[i], resource);
+      count += p.add_post(key, preprocessed_post, sum);
+      if (record) {
+        tg.cache().add_post(key, preprocessed_post);
+      }
+    }
+  }
+  return count;
+}
+
+static
+void detect_language(const TelegramChannelInfo *channel_info,
+                     char language_code[6]) {
+  const auto lp = tg.language_predictor();
+  Vector sum(lp->dimension());
+  sum.zero();
+  const auto count = embed(*lp, channel_info, sum, true);
+  const auto predictions = lp->predict(sum, count);
+  if (predictions.empty()) {
+    tg.cache().reset();
+    return;
+  }
+
+  const auto [_, label] = predictions.at(0);
+  const auto& code = lp->language_code(label);
+  memcpy(language_code, code.c_str(), code.size());
+  tg.cache().set_code(code);
+}
+
+static
+void detect_category(const TelegramChannelInfo *channel_info,
+                     double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
+  memset(category_probability, 0, sizeof(double) * (TGCAT_CATEGORY_OTHER + 1));
+
+  const auto cp = tg.cp.get(tg.cache().get_code());
+  if (!cp) {
+    return;
+  }
+  Vector sum(cp->dimension());
+  sum.zero();
+  const auto count = embed(*cp, channel_info, sum, false);
+  if (cp->predict_distribution(sum, count, category_probability,
+                               TGCAT_CATEGORY_OTHER + 1)) {
+    tg.cache().reset();
+  }
+}
+
+} // UseCase__Embedded
+
+// ---- Script ----
+
+namespace UseCase__Script {
+
+// Names the language from the script of the channel if it is decisive.
+static
+bool detect_language(const TelegramChannelInfo *channel_info,
+                     char language_code[6]) {
+  ScriptHistogram histogram;
+  histogram.add(channel_info->title);
+  histogram.add(channel_info->description);
+  for (std::size_t i = 0; i != channel_info->post_count; ++i) {
+    histogram.add(channel_info->posts[i]);
+  }
+  const auto code = histogram.language(Config::Script::min_letters,
+                                       Config::Script::min_share);
+  if (code == nullptr) {
+    return false;
+  }
+
+  memcpy(language_code, code, strlen(code));
+  // only languages with a category model need the preprocessed text
+  if (tg.cp.contains(code) && Config::PostCache::capacity != 0) {
+    UseCase__Embedded::record_head(channel_info, code);
+  } else if (tg.cp.contains(code)) {
+    const auto data = UseCase__Complete::get_channel_data(channel_info);
+    tg.cache().set(tg.pp->preprocess(data, data.get_allocator().resource()), code);
+  } else {
+    tg.cache().set({}, code);
+  }
+  return true;
+}
+
+} // UseCase__Script
+
 // ---- Randomized ----
 
 namespace UseCase__Randomized {
 
 static
-std::string get_channel_data(const TelegramChannelInfo *channel_info,
-                             const bool is_unique = false) noexcept {
-  const auto indices = get_random_indices(channel_info->post_count,
-                                          Config::Randomized::posts_threshold);
-  auto data = std::string{channel_info->title};
-  data += ' ' + std::string{channel_info->description};
+String get_channel_data(const TelegramChannelInfo *channel_info,
+                        const bool is_unique = false) noexcept {
+  const auto resource = Arena::local().resource();
+  auto data = get_channel_head(channel_info, resource);
   const auto count = channel_info->post_count;
   const auto posts = channel_info->posts;
   if (is_unique) {
-    std::set<std::string> unique_posts;
+    const auto indices = get_random_indices(count, Config::Randomized::posts_threshold);
+    std::pmr::set<std::string_view> unique_posts{resource};
     for (const auto i : indices) {
       unique_posts.emplace(posts[i]);
     }
     for (const auto post : unique_posts) {
-      data += ' ' + post;
+      data += ' ';
+      data += post;
     }
   } else {
-    for (std::size_t i = 0; i != count; ++i) {
-      data += ' ' + std::string{posts[i]};
-    }
+    append_posts(data, posts, count);
   }
   return data;
 }
 
+// Votes over passes on `posts_threshold` posts sampled at random, each of
+// which may name another language. The categories are detected on the whole
+// channel.
 static
 void detect_language(const TelegramChannelInfo *channel_info,
                      char language_code[6]) {
-  std::unordered_map<std::string, std::pair<std::string, std::size_t>> lookup_table;
-  for (std::size_t i{0}; i != Config::Randomized::no_of_passes; ++i) {
-    const auto data = get_channel_data(channel_info);
-    const auto preprocessed_data = tg.pp->preprocess(data);
-    const auto predictions = tg.lp->predict(preprocessed_data);
+  using namespace Config::Randomized;
+  const auto lp = tg.language_predictor();
+  // with no more posts than a sample holds every pass sees the same text
+  const auto passes = channel_info->post_count > posts_threshold ? no_of_passes : 1;
+  // codes refer to the labels of `lp`
+  std::pmr::unordered_map<std::string_view, std::size_t> votes_of{Arena::local().resource()};
+  for (std::size_t i{0}; i != passes; ++i) {
+    ++tg.language_passes;
+    const auto data = get_channel_data(channel_info, true);
+    const auto preprocessed_data = tg.pp->preprocess(data, data.get_allocator().resource());
+    const auto predictions = lp->predict(preprocessed_data, 2);
     if (!predictions.empty()) {
-      const auto [_, label] = predictions.at(0);
-      const auto code = get_valid_language_code(label);
-      if (auto it = lookup_table.find(code); it != lookup_table.end()) {
-        it->second.first = preprocessed_data;
-        it->second.second++;
-      } else {
-        lookup_table[code] = {preprocessed_data, 1};
+      const auto [probability, label] = predictions.at(0);
+      const std::string_view code = lp->language_code(label);
+      const auto votes = ++votes_of[code];
+
+      // stop once the leading language cannot be beaten by the remaining
+      // passes, or once a pass agreeing with it is confident enough
+      std::size_t runner_up{0};
+      for (const auto& [c, v] : votes_of) {
+        if (c != code) {
+          runner_up = std::max(runner_up, v);
+        }
+      }
+      const auto remaining = passes - i - 1;
+      // `Predictor::predict()` gives probabilities, not log-probabilities
+      const auto margin = probability - (predictions.size() > 1 ? predictions[1].first : 0.0f);
+      if (remaining != 0 && votes > runner_up &&
+          (votes > runner_up + remaining || margin >= early_exit_margin)) {
+        ++tg.language_early_stops;
+        break;
       }
     }
   }
 
-  std::string code;
-  std::string preprocessed_data;
+  std::string_view code;
   std::size_t frequency{0};
-  for (const auto& [c, p] : lookup_table) {
-    if (frequency < p.second) {
+  for (const auto& [c, v] : votes_of) {
+    if (frequency < v) {
       code = c;
-      preprocessed_data = p.first;
-      frequency = p.second;
+      frequency = v;
     }
   }
+  if (code.empty()) {
+    tg.cache().reset();
+    return;
+  }
 
-  memcpy(language_code, code.c_str(), code.size());
-  tg.cache.set(preprocessed_data, code);
+  memcpy(language_code, code.data(), code.size());
+  if (tg.cp.contains(std::string{code})) {
+    const auto data = UseCase__Complete::get_channel_data(channel_info);
+    tg.cache().set(tg.pp->preprocess(data, data.get_allocator().resource()), code);
+  } else {
+    tg.cache().set({}, code);
+  }
 }
 
 } // UseCase__Randomized
 
+// ---- Incremental ----
+
+// Channels kept by the caller and classified as they grow, see `TgcatChannel`.
+// The sums are those of `UseCase__Complete` on the whole text, without the
+// byte budget: the word ngrams across posts are carried by the windows of the
+// sums, so posts are not taken from the post cache.
+namespace UseCase__Incremental {
+
+using Predictor_t = tgcat_manager_s::Predictor_t;
+
+// Predictor of a sum of the channel, `nullptr` if it is not loaded or if it
+// is not the model the sum was made with.
+static
+Predictor_t predictor_of(const TgcatChannel::Sum& sum) noexcept {
+  auto predictor = sum.code.empty() ? tg.language_predictor() : tg.cp.get(sum.code);
+  if (!predictor || predictor->fingerprint() != sum.fingerprint ||
+      sum.sum.size() != static_cast<std::size_t>(predictor->dimension()) ||
+      sum.window.size() + 1 > static_cast<std::size_t>(std::max(predictor->word_ngrams(), 1))) {
+    return nullptr;
+  }
+  return predictor;
+}
+
+// Adds the rows of a preprocessed text to a sum of the channel.
+static
+void add(TgcatChannel::Sum& sum, const Predictor& predictor, const std::string_view preprocessed) {
+  Vector vector(sum.sum.size());
+  std::copy(sum.sum.begin(), sum.sum.end(), vector.data());
+  sum.count += predictor.embed(preprocessed, vector, sum.window);
+  std::copy(vector.data(), vector.data() + vector.size(), sum.sum.begin());
+}
+
+// Adds a text to every sum of the channel. Returns false, leaving the channel
+// unchanged, if a model changed since the channel was created.
+static
+bool append(TgcatChannel& channel, const std::string_view text) {
+  std::vector<Predictor_t> predictors;
+  for (const auto& sum : channel.sums) {
+    predictors.push_back(predictor_of(sum));
+    if (!predictors.back()) {
+      return false;
+    }
+  }
+  const auto preprocessed = tg.pp->preprocess(text, Arena::local().resource());
+  for (std::size_t i = 0; i != channel.sums.size(); ++i) {
+    add(channel.sums[i], *predictors[i], preprocessed);
+  }
+  return true;
+}
+
+static
+std::unique_ptr<TgcatChannel> create(const char *title, const char *description) {
+  auto channel = std::make_unique<TgcatChannel>();
+  const auto lp = tg.language_predictor();
+  if (!lp) {
+    return nullptr;
+  }
+  channel->sums.push_back({{}, lp->fingerprint(), 0, std::vector<real>(lp->dimension())});
+  for (const auto& category : Config::Language::Model::categories) {
+    if (const auto cp = tg.cp.get(category.code)) {
+      channel->sums.push_back({category.code, cp->fingerprint(), 0,
+                               std::vector<real>(cp->dimension())});
+    }
+  }
+
+  channel->script.add(title);
+  channel->script.add(description);
+  const TelegramChannelInfo info{title, description, 0, nullptr};
+  const auto head = get_channel_head(&info, Arena::local().resource());
+  return append(*channel, head) ? std::move(channel) : nullptr;
+}
+
+static
+bool detect_language(const TgcatChannel& channel, std::string& code) {
+  if (Config::Script::enabled) {
+    if (const auto script_code = channel.script.language(Config::Script::min_letters,
+                                                         Config::Script::min_share)) {
+      code = script_code;
+      return true;
+    }
+  }
+  const auto& sum = channel.sums.front();
+  const auto lp = predictor_of(sum);
+  if (!lp) {
+    return false;
+  }
+  Vector vector(sum.sum.size());
+  std::copy(sum.sum.begin(), sum.sum.end(), vector.data());
+  const auto predictions = lp->predict(vector, sum.count);
+  code = predictions.empty() ? "" : lp->language_code(predictions.at(0).second);
+  return true;
+}
+
+static
+bool detect_category(const TgcatChannel& channel,
+                     double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
+  memset(category_probability, 0, sizeof(double) * (TGCAT_CATEGORY_OTHER + 1));
+  std::string code;
+  if (!detect_language(channel, code)) {
+    return false;
+  }
+  const auto sum = channel.find(code);
+  if (sum == nullptr || code.empty()) {
+    return true;
+  }
+  const auto cp = predictor_of(*sum);
+  if (!cp) {
+    return false;
+  }
+  Vector vector(sum->sum.size());
+  std::copy(sum->sum.begin(), sum->sum.end(), vector.data());
+  cp->predict_distribution(vector, sum->count, category_probability, TGCAT_CATEGORY_OTHER + 1);
+  return true;
+}
+
+} // UseCase__Incremental
+
+// ---- Dispatch ----
+
+static
+void run_language_detection(const TelegramChannelInfo *channel_info,
+                            char language_code[6]) {
+  if (Config::Script::enabled &&
+      UseCase__Script::detect_language(channel_info, language_code)) {
+    ++tg.language_script_hits;
+    return;
+  }
+  if (Config::PostCache::capacity != 0) {
+    UseCase__Embedded::detect_language(channel_info, language_code);
+  } else if (channel_info->post_count < Config::Randomized::posts_threshold) {
+    UseCase__Complete::detect_language(channel_info, language_code);
+  } else {
+    UseCase__Randomized::detect_language(channel_info, language_code);
+  }
+}
+
+static
+void run_category_detection(const TelegramChannelInfo *channel_info,
+                            double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
+  if (Config::PostCache::capacity != 0) {
+    UseCase__Embedded::detect_category(channel_info, category_probability);
+  } else {
+    detect_category(channel_info, category_probability);
+  }
+}
+
+// Key of a channel in the result cache, a hash of its title, description and
+// posts.
+static
+std::uint64_t channel_key(const TelegramChannelInfo *channel_info) noexcept {
+  auto key = hash_bytes(channel_info->title, tg.generation.load());
+  key = hash_bytes(channel_info->description, key);
+  for (std::size_t i = 0; i != channel_info->post_count; ++i) {
+    key = hash_bytes(channel_info->posts[i], key);
+  }
+  return key;
+}
+
 // libtgcat
 
 int tgcat_init() {
-  return tg.init();
+  return tg.init(TGCAT_MODEL_LOADING_EAGER);
+}
+
+int tgcat_init_with_loading(enum TgcatModelLoading loading) {
+  return tg.init(loading);
+}
+
+int tgcat_reload_models() {
+  return tg.reload();
+}
+
+int tgcat_get_stats(struct TgcatStats *stats) {
+  const auto cp_stats = tg.cp.stats();
+  stats->model_loads = cp_stats.loads;
+  stats->model_evictions = cp_stats.evictions;
+  stats->model_hits = cp_stats.hits;
+  stats->model_memory = cp_stats.memory;
+  stats->language_requests = tg.language_requests;
+  stats->language_script_hits = tg.language_script_hits;
+  stats->language_passes = tg.language_passes;
+  stats->language_early_stops = tg.language_early_stops;
+  const auto post_cache_stats = tg.post_cache_stats();
+  stats->post_cache_hits = post_cache_stats.hits;
+  stats->post_cache_misses = post_cache_stats.misses;
+  stats->post_cache_size = post_cache_stats.size;
+  const auto result_cache_stats = tg.results.stats();
+  stats->result_cache_hits = result_cache_stats.hits;
+  stats->result_cache_misses = result_cache_stats.misses;
+  stats->result_cache_size = result_cache_stats.size;
+  stats->result_cache_memory = result_cache_stats.memory;
+  return 0;
 }
 
 int tgcat_detect_language(const struct TelegramChannelInfo *channel_info,
                           char language_code[6]) {
-  if (channel_info->post_count < Config::Randomized::posts_threshold) {
-    UseCase__Complete::detect_language(channel_info, language_code);
-  } else {
-    UseCase__Randomized::detect_language(channel_info, language_code);
+  const Arena::Scope scope;
+  ++tg.language_requests;
+  if (Config::ResultCache::capacity == 0) {
+    run_language_detection(channel_info, language_code);
+    return 0;
   }
+
+  auto& pending = tg.pending();
+  pending.key = channel_key(channel_info);
+  pending.valid = true;
+  pending.found = tg.results.find(pending.key, [&pending](const auto& result) {
+    pending.result = result;
+  });
+  if (pending.found) {
+    const auto& code = pending.result.language_code;
+    memcpy(language_code, code, strlen(code));
+    return 0;
+  }
+
+  run_language_detection(channel_info, language_code);
+  const auto& code = tg.cache().get_code();
+  auto& result_code = pending.result.language_code;
+  memset(result_code, 0, sizeof(result_code));
+  memcpy(result_code, code.data(), std::min(code.size(), sizeof(result_code) - 1));
   return 0;
 }
 
 int tgcat_detect_category(const struct TelegramChannelInfo *channel_info,
                           double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
-  detect_category(channel_info, category_probability);
+  const Arena::Scope scope;
+  auto& pending = tg.pending();
+  const auto cached = Config::ResultCache::capacity != 0 && pending.valid &&
+                      pending.key == channel_key(channel_info);
+  pending.valid = false;
+  const auto size = sizeof(double) * (TGCAT_CATEGORY_OTHER + 1);
+  if (cached && pending.found) {
+    memcpy(category_probability, pending.result.category_probability, size);
+    return 0;
+  }
+
+  // the language state of the thread is not the one of this channel after a
+  // result cache hit, or after a reload or another channel in between
+  if (Config::ResultCache::capacity != 0 && (!cached || pending.found)) {
+    char language_code[6] = {0};
+    run_language_detection(channel_info, language_code);
+  }
+  run_category_detection(channel_info, category_probability);
+  // a reload in the meantime changes the key, its result must not be cached
+  if (cached && pending.key == channel_key(channel_info)) {
+    memcpy(pending.result.category_probability, category_probability, size);
+    tg.results.insert(pending.key, pending.result);
+  }
   return 0;
 }
+
+TgcatChannel *tgcat_channel_create(const char *title, const char *description) {
+  const Arena::Scope scope;
+  try {
+    return UseCase__Incremental::create(title, description).release();
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+int tgcat_channel_append_posts(TgcatChannel *channel, const char **posts,
+                               size_t post_count) {
+  const Arena::Scope scope;
+  try {
+    for (std::size_t i = 0; i != post_count; ++i) {
+      if (!UseCase__Incremental::append(*channel, posts[i])) {
+        return -1;
+      }
+      channel->script.add(posts[i]);
+      ++channel->posts;
+    }
+  } catch (const std::exception&) {
+    return -1;
+  }
+  return 0;
+}
+
+int tgcat_channel_detect_language(const TgcatChannel *channel, char language_code[6]) {
+  std::string code;
+  if (!UseCase__Incremental::detect_language(*channel, code)) {
+    return -1;
+  }
+  memcpy(language_code, code.c_str(), code.size());
+  return 0;
+}
+
+int tgcat_channel_detect_category(const TgcatChannel *channel,
+                                  double category_probability[TGCAT_CATEGORY_OTHER + 1]) {
+  return UseCase__Incremental::detect_category(*channel, category_probability) ? 0 : -1;
+}
+
+size_t tgcat_channel_serialize(const TgcatChannel *channel, void *buffer, size_t size) {
+  const auto needed = channel->serialized_size();
+  if (buffer != nullptr && size >= needed) {
+    channel->serialize(static_cast<unsigned char *>(buffer));
+  }
+  return needed;
+}
+
+TgcatChannel *tgcat_channel_deserialize(const void *data, size_t size) {
+  try {
+    return TgcatChannel::deserialize(static_cast<const unsigned char *>(data), size).release();
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void tgcat_channel_destroy(TgcatChannel *channel) {
+  delete channel;
+}
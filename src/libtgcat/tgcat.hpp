@@ -28,6 +28,126 @@ extern "C" {
  */
 TGCAT_EXPORT int tgcat_init();
 
+/**
+ * Loading strategies for category models.
+ */
+enum TgcatModelLoading {
+  /**
+   * Category models are loaded by the initialization call.
+   */
+  TGCAT_MODEL_LOADING_EAGER,
+
+  /**
+   * A category model is loaded by the first request which needs it.
+   */
+  TGCAT_MODEL_LOADING_LAZY,
+
+  /**
+   * Category models are loaded on background threads once the language model
+   * is ready. Requests which need a model that is still loading wait for it.
+   */
+  TGCAT_MODEL_LOADING_BACKGROUND
+};
+
+/**
+ * Initializes the library with the given category model loading strategy.
+ * Can be called instead of tgcat_init. With TGCAT_MODEL_LOADING_LAZY and
+ * TGCAT_MODEL_LOADING_BACKGROUND returns as soon as languages can be detected.
+ * \param[in] loading Loading strategy for category models.
+ * \return 0 on success and a negative value on fail.
+ */
+TGCAT_EXPORT int tgcat_init_with_loading(enum TgcatModelLoading loading);
+
+/**
+ * Reloads the language model and the category models which are in use from
+ * their files, e.g. after they have been replaced by retrained ones. Other
+ * requests are not blocked meanwhile: they are served by the previous models,
+ * which are released once the last request using them has finished.
+ * \return 0 on success and a negative value on fail. On fail the previous
+ *         models stay in use.
+ */
+TGCAT_EXPORT int tgcat_reload_models();
+
+/**
+ * Runtime statistics of the library.
+ */
+struct TgcatStats {
+  /**
+   * Number of category model loads, including reloads after eviction.
+   */
+  size_t model_loads;
+
+  /**
+   * Number of category models evicted to stay within the memory budget.
+   */
+  size_t model_evictions;
+
+  /**
+   * Number of category requests served by an already loaded model.
+   */
+  size_t model_hits;
+
+  /**
+   * Estimated memory of the loaded category models in bytes.
+   */
+  size_t model_memory;
+
+  /**
+   * Number of language requests.
+   */
+  size_t language_requests;
+
+  /**
+   * Number of language requests decided by the script of the channel alone,
+   * without running the language model.
+   */
+  size_t language_script_hits;
+
+  /**
+   * Number of language predictions made by the voting of channels with many
+   * posts.
+   */
+  size_t language_passes;
+
+  /**
+   * Number of votings stopped before their last pass, because the leading
+   * language could no longer be beaten or a pass was confident enough.
+   */
+  size_t language_early_stops;
+
+  /**
+   * Number of posts whose embedding was found in the post cache of a model
+   * in use, and of those embedded and added to it.
+   */
+  size_t post_cache_hits;
+  size_t post_cache_misses;
+
+  /**
+   * Number of posts in the post caches of the models in use.
+   */
+  size_t post_cache_size;
+
+  /**
+   * Number of language requests answered from the result cache, and of those
+   * that were not. The hit rate is hits / (hits + misses).
+   */
+  size_t result_cache_hits;
+  size_t result_cache_misses;
+
+  /**
+   * Number of channels in the result cache and its estimated memory in bytes.
+   */
+  size_t result_cache_size;
+  size_t result_cache_memory;
+};
+
+/**
+ * Reports runtime statistics of the library.
+ * \param[out] stats Statistics to be filled.
+ * \return 0 on success and a negative value on fail.
+ */
+TGCAT_EXPORT int tgcat_get_stats(struct TgcatStats *stats);
+
 /**
  * Information about a Telegram channel.
  */
@@ -170,6 +290,74 @@ const char *TGCAT_CATEGORY_NAME[] = {
 TGCAT_EXPORT int tgcat_detect_category(const struct TelegramChannelInfo *channel_info,
                                        double category_probability[TGCAT_CATEGORY_OTHER + 1]);
 
+/**
+ * State of a channel which is classified as it grows. It holds what the
+ * models need from the text of the channel, so every post is processed once,
+ * when it is appended, and the text itself is not kept. Its results are those
+ * of tgcat_detect_language and tgcat_detect_category on the whole text of the
+ * channel, with neither the sampling of channels with many posts nor the byte
+ * budget. A channel may be used by one thread at a time.
+ */
+struct TgcatChannel;
+
+/**
+ * Creates the state of a channel from its title and description.
+ * \param[in] title Title of the channel. A null-terminated string in UTF-8 encoding.
+ * \param[in] description Description of the channel. A null-terminated string in UTF-8 encoding.
+ * \return The channel, to be released by tgcat_channel_destroy, or NULL on fail.
+ */
+TGCAT_EXPORT struct TgcatChannel *tgcat_channel_create(const char *title, const char *description);
+
+/**
+ * Appends new posts to a channel, in time proportional to their length.
+ * \param[in] channel The channel.
+ * \param[in] posts List of post_count new posts. Posts are null-terminated strings in UTF-8 encoding.
+ * \param[in] post_count Number of new posts.
+ * \return 0 on success and a negative value on fail. Fails if the models were
+ *         reloaded with different ones since the channel was created, the
+ *         channel has to be created again then; posts before the failed one
+ *         are appended.
+ */
+TGCAT_EXPORT int tgcat_channel_append_posts(struct TgcatChannel *channel, const char **posts,
+                                            size_t post_count);
+
+/**
+ * Detects main language of a channel from its current state, see tgcat_detect_language.
+ * \return 0 on success and a negative value on fail, see tgcat_channel_append_posts.
+ */
+TGCAT_EXPORT int tgcat_channel_detect_language(const struct TgcatChannel *channel,
+                                               char language_code[6]);
+
+/**
+ * Detects main topic of a channel from its current state, see tgcat_detect_category.
+ * \return 0 on success and a negative value on fail, see tgcat_channel_append_posts.
+ */
+TGCAT_EXPORT int tgcat_channel_detect_category(const struct TgcatChannel *channel,
+                                               double category_probability[TGCAT_CATEGORY_OTHER + 1]);
+
+/**
+ * Serializes the state of a channel, to be stored and restored by
+ * tgcat_channel_deserialize on a host of the same byte order. Its size does
+ * not grow with the posts.
+ * \param[in] channel The channel.
+ * \param[out] buffer Buffer to be filled, may be NULL to query the size.
+ * \param[in] size Size of the buffer in bytes.
+ * \return Size of the serialized state. The buffer is filled only if it is large enough.
+ */
+TGCAT_EXPORT size_t tgcat_channel_serialize(const struct TgcatChannel *channel, void *buffer,
+                                            size_t size);
+
+/**
+ * Restores a channel serialized by tgcat_channel_serialize.
+ * \return The channel, to be released by tgcat_channel_destroy, or NULL if the data is malformed.
+ */
+TGCAT_EXPORT struct TgcatChannel *tgcat_channel_deserialize(const void *data, size_t size);
+
+/**
+ * Releases a channel.
+ */
+TGCAT_EXPORT void tgcat_channel_destroy(struct TgcatChannel *channel);
+
 #ifdef __cplusplus
 }
 #endif